@@ -1,5 +1,7 @@
+VERSION = File.read("jsonh_cpp/jsonh_version.hpp")[/jsonh_cpp_version = "([^"]+)"/, 1]
+
 HEADER = "// JsonhCpp (JSON for Humans)
-// Version: 8.0
+// Version: #{VERSION}
 // Link: https://github.com/jsonh-org/JsonhCpp
 // License: MIT"
 
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstdint>
+
+namespace jsonh_cpp {
+
+/**
+* @brief The binary formats that JSONH can be transcoded to.
+**/
+enum struct jsonh_binary_format : uint8_t {
+    /**
+    * @brief Concise Binary Object Representation (RFC 8949).
+    *
+    * Objects and arrays are written with indefinite lengths.
+    **/
+    cbor = 0,
+    /**
+    * @brief MessagePack.
+    *
+    * Objects and arrays are written with 32-bit lengths.
+    **/
+    msgpack = 1,
+    /**
+    * @brief Binary JSON. The root element must be an object.
+    **/
+    bson = 2,
+    /**
+    * @brief Universal Binary JSON.
+    *
+    * Objects and arrays are written without counts.
+    **/
+    ubjson = 3,
+};
+
+}
\ No newline at end of file
@@ -0,0 +1,473 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <ostream>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+#include <utility>
+#include <cstring>
+#include <bit>
+#include "martinmoene/expected.hpp"
+#include "jsonh_token.hpp"
+#include "jsonh_token_type.hpp"
+#include "jsonh_binary_format.hpp"
+#include "jsonh_number_parser.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief A writer that transcodes JSONH tokens to a binary format in a single pass.
+*
+* Primitive values are encoded the same way as nlohmann/json encodes a parsed element,
+* except for the lengths of objects and arrays (see @ref jsonh_binary_format).
+*
+* CBOR and UBJSON are written to the output after each token.
+* MessagePack and BSON lengths precede their contents, so they are written as placeholders and filled in at the end of the structure,
+* and each root element is buffered until it ends.
+**/
+class jsonh_binary_writer {
+public:
+    /**
+    * @brief The format to write.
+    **/
+    jsonh_binary_format format;
+    /**
+    * @brief The stream the bytes are written to.
+    **/
+    std::ostream& output;
+
+    /**
+    * @brief Constructs a writer that writes the given format to @c output.
+    **/
+    explicit jsonh_binary_writer(jsonh_binary_format format, std::ostream& output) noexcept
+        : format(format), output(output) {
+    }
+
+    /**
+    * @brief Returns whether a complete root element has been written.
+    **/
+    bool is_complete() const noexcept {
+        return has_root && structures.empty();
+    }
+    /**
+    * @brief Writes a single token (comments are ignored).
+    **/
+    nonstd::expected<void, std::string> write_token(const jsonh_token& token) noexcept {
+        nonstd::expected<void, std::string> result = write_token_to_buffer(token);
+        if (!result) {
+            return result;
+        }
+
+        // Flush bytes that will not be filled in
+        if (structures.empty() || format == jsonh_binary_format::cbor || format == jsonh_binary_format::ubjson) {
+            output.write((const char*)buffer.data(), (std::streamsize)buffer.size());
+            buffer.clear();
+            if (output.fail()) {
+                return nonstd::unexpected<std::string>("Failed to write to output");
+            }
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+
+private:
+    /**
+    * @brief An object or array that has been started but not ended.
+    **/
+    struct structure {
+        bool is_object;
+        size_t header_position;
+        uint32_t count;
+    };
+
+    std::vector<std::uint8_t> buffer;
+    std::vector<structure> structures;
+    std::string property_name;
+    bool has_root = false;
+
+    nonstd::expected<void, std::string> write_token_to_buffer(const jsonh_token& token) noexcept {
+        switch (token.json_type) {
+            // Null
+            case json_token_type::null: {
+                return write_primitive(json_token_type::null, 0, "");
+            }
+            // True/False
+            case json_token_type::true_bool: case json_token_type::false_bool: {
+                return write_primitive(token.json_type, 0, "");
+            }
+            // String
+            case json_token_type::string: {
+                return write_primitive(json_token_type::string, 0, token.value);
+            }
+            // Number
+            case json_token_type::number: {
+                nonstd::expected<long double, std::string> result = jsonh_number_parser::parse(token.value);
+                if (!result) {
+                    return nonstd::unexpected<std::string>(result.error());
+                }
+                return write_primitive(json_token_type::number, (double)result.value(), "");
+            }
+            // Start Object/Array
+            case json_token_type::start_object: case json_token_type::start_array: {
+                return write_start_of_structure(token.json_type == json_token_type::start_object);
+            }
+            // End Object/Array
+            case json_token_type::end_object: case json_token_type::end_array: {
+                return write_end_of_structure();
+            }
+            // Property Name
+            case json_token_type::property_name: {
+                return write_property_name(token.value);
+            }
+            // Comment
+            case json_token_type::comment: {
+                return nonstd::expected<void, std::string>(); // Success
+            }
+            // Not implemented
+            default: {
+                return nonstd::unexpected<std::string>("Token type not implemented");
+            }
+        }
+    }
+    nonstd::expected<void, std::string> write_primitive(json_token_type type, double number, std::string_view string) noexcept {
+        // BSON root
+        if (format == jsonh_binary_format::bson && structures.empty()) {
+            return nonstd::unexpected<std::string>("Expected object at root of BSON document");
+        }
+
+        nonstd::expected<void, std::string> start_result = write_start_of_value(bson_type(type));
+        if (!start_result) {
+            return start_result;
+        }
+
+        switch (type) {
+            // Null
+            case json_token_type::null: {
+                switch (format) {
+                    case jsonh_binary_format::cbor: buffer.push_back(0xF6); break;
+                    case jsonh_binary_format::msgpack: buffer.push_back(0xC0); break;
+                    case jsonh_binary_format::ubjson: buffer.push_back('Z'); break;
+                    case jsonh_binary_format::bson: break;
+                }
+                break;
+            }
+            // True
+            case json_token_type::true_bool: {
+                switch (format) {
+                    case jsonh_binary_format::cbor: buffer.push_back(0xF5); break;
+                    case jsonh_binary_format::msgpack: buffer.push_back(0xC3); break;
+                    case jsonh_binary_format::ubjson: buffer.push_back('T'); break;
+                    case jsonh_binary_format::bson: buffer.push_back(0x01); break;
+                }
+                break;
+            }
+            // False
+            case json_token_type::false_bool: {
+                switch (format) {
+                    case jsonh_binary_format::cbor: buffer.push_back(0xF4); break;
+                    case jsonh_binary_format::msgpack: buffer.push_back(0xC2); break;
+                    case jsonh_binary_format::ubjson: buffer.push_back('F'); break;
+                    case jsonh_binary_format::bson: buffer.push_back(0x00); break;
+                }
+                break;
+            }
+            // Number
+            case json_token_type::number: {
+                write_number(number);
+                break;
+            }
+            // String
+            default: {
+                if (format == jsonh_binary_format::ubjson) {
+                    buffer.push_back('S');
+                }
+                write_string(string);
+                break;
+            }
+        }
+        has_root = true;
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    nonstd::expected<void, std::string> write_start_of_structure(bool is_object) noexcept {
+        // BSON root
+        if (format == jsonh_binary_format::bson && structures.empty() && !is_object) {
+            return nonstd::unexpected<std::string>("Expected object at root of BSON document");
+        }
+
+        nonstd::expected<void, std::string> start_result = write_start_of_value(is_object ? 0x03 : 0x04);
+        if (!start_result) {
+            return start_result;
+        }
+
+        structures.push_back(structure({ is_object, buffer.size(), 0 }));
+        switch (format) {
+            // Indefinite length
+            case jsonh_binary_format::cbor: {
+                buffer.push_back(is_object ? 0xBF : 0x9F);
+                break;
+            }
+            // 32-bit length placeholder
+            case jsonh_binary_format::msgpack: {
+                buffer.push_back(is_object ? 0xDF : 0xDD);
+                buffer.insert(buffer.end(), 4, 0);
+                break;
+            }
+            // Document size placeholder
+            case jsonh_binary_format::bson: {
+                buffer.insert(buffer.end(), 4, 0);
+                break;
+            }
+            // No count
+            case jsonh_binary_format::ubjson: {
+                buffer.push_back(is_object ? '{' : '[');
+                break;
+            }
+        }
+        has_root = true;
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    nonstd::expected<void, std::string> write_end_of_structure() noexcept {
+        if (structures.empty()) {
+            return nonstd::unexpected<std::string>("Unexpected end of structure");
+        }
+        structure current_structure = structures.back();
+        structures.pop_back();
+
+        switch (format) {
+            // Break
+            case jsonh_binary_format::cbor: {
+                buffer.push_back(0xFF);
+                break;
+            }
+            // Fill in count (big-endian)
+            case jsonh_binary_format::msgpack: {
+                for (size_t index = 0; index < 4; index++) {
+                    buffer[current_structure.header_position + 1 + index] = (std::uint8_t)(current_structure.count >> (24 - (index * 8)));
+                }
+                break;
+            }
+            // Fill in document size (little-endian)
+            case jsonh_binary_format::bson: {
+                buffer.push_back(0x00);
+                size_t size = buffer.size() - current_structure.header_position;
+                if (size > INT32_MAX) {
+                    return nonstd::unexpected<std::string>("BSON document too large");
+                }
+                for (size_t index = 0; index < 4; index++) {
+                    buffer[current_structure.header_position + index] = (std::uint8_t)(size >> (index * 8));
+                }
+                break;
+            }
+            // End marker
+            case jsonh_binary_format::ubjson: {
+                buffer.push_back(current_structure.is_object ? '}' : ']');
+                break;
+            }
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    nonstd::expected<void, std::string> write_property_name(const std::string& name) noexcept {
+        if (structures.empty() || !structures.back().is_object) {
+            return nonstd::unexpected<std::string>("Unexpected property name");
+        }
+
+        switch (format) {
+            // Written with the value
+            case jsonh_binary_format::bson: {
+                if (name.find('\0') != std::string::npos) {
+                    return nonstd::unexpected<std::string>("BSON property name cannot contain null character");
+                }
+                property_name = name;
+                break;
+            }
+            // String (without type marker in UBJSON)
+            default: {
+                write_string(name);
+                break;
+            }
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    nonstd::expected<void, std::string> write_start_of_value(std::uint8_t bson_type) noexcept {
+        if (structures.empty()) {
+            if (has_root) {
+                return nonstd::unexpected<std::string>("Expected single element");
+            }
+            return nonstd::expected<void, std::string>(); // Success
+        }
+        structure& parent = structures.back();
+        parent.count++;
+
+        // BSON element header
+        if (format == jsonh_binary_format::bson) {
+            buffer.push_back(bson_type);
+            if (parent.is_object) {
+                buffer.insert(buffer.end(), property_name.begin(), property_name.end());
+            }
+            else {
+                std::string index = std::to_string(parent.count - 1);
+                buffer.insert(buffer.end(), index.begin(), index.end());
+            }
+            buffer.push_back(0x00);
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    void write_number(double number) noexcept {
+        switch (format) {
+            case jsonh_binary_format::cbor: {
+                // NaN and infinity as half-precision
+                if (std::isnan(number)) {
+                    buffer.insert(buffer.end(), { 0xF9, 0x7E, 0x00 });
+                }
+                else if (std::isinf(number)) {
+                    buffer.insert(buffer.end(), { 0xF9, (std::uint8_t)(number > 0 ? 0x7C : 0xFC), 0x00 });
+                }
+                // Single-precision if exact
+                else if (is_exact_float(number)) {
+                    buffer.push_back(0xFA);
+                    write_big_endian((float)number);
+                }
+                // Double-precision
+                else {
+                    buffer.push_back(0xFB);
+                    write_big_endian(number);
+                }
+                break;
+            }
+            case jsonh_binary_format::msgpack: {
+                // Single-precision if exact (or not finite)
+                if (!std::isfinite(number) || is_exact_float(number)) {
+                    buffer.push_back(0xCA);
+                    write_big_endian((float)number);
+                }
+                // Double-precision
+                else {
+                    buffer.push_back(0xCB);
+                    write_big_endian(number);
+                }
+                break;
+            }
+            case jsonh_binary_format::ubjson: {
+                buffer.push_back('D');
+                write_big_endian(number);
+                break;
+            }
+            // Double (little-endian)
+            case jsonh_binary_format::bson: {
+                std::uint8_t bytes[sizeof(double)];
+                std::memcpy(bytes, &number, sizeof(double));
+                for (size_t index = 0; index < sizeof(double); index++) {
+                    buffer.push_back(bytes[std::endian::native == std::endian::little ? index : sizeof(double) - 1 - index]);
+                }
+                break;
+            }
+        }
+    }
+    void write_string(std::string_view string) noexcept {
+        size_t size = string.size();
+        switch (format) {
+            // Major type 3 with length
+            case jsonh_binary_format::cbor: {
+                if (size <= 0x17) {
+                    buffer.push_back((std::uint8_t)(0x60 + size));
+                }
+                else if (size <= UINT8_MAX) {
+                    buffer.push_back(0x78);
+                    write_big_endian((std::uint8_t)size);
+                }
+                else if (size <= UINT16_MAX) {
+                    buffer.push_back(0x79);
+                    write_big_endian((std::uint16_t)size);
+                }
+                else if (size <= UINT32_MAX) {
+                    buffer.push_back(0x7A);
+                    write_big_endian((std::uint32_t)size);
+                }
+                else {
+                    buffer.push_back(0x7B);
+                    write_big_endian((std::uint64_t)size);
+                }
+                break;
+            }
+            // fixstr, str 8, str 16 or str 32
+            case jsonh_binary_format::msgpack: {
+                if (size <= 31) {
+                    buffer.push_back((std::uint8_t)(0xA0 | size));
+                }
+                else if (size <= UINT8_MAX) {
+                    buffer.push_back(0xD9);
+                    write_big_endian((std::uint8_t)size);
+                }
+                else if (size <= UINT16_MAX) {
+                    buffer.push_back(0xDA);
+                    write_big_endian((std::uint16_t)size);
+                }
+                else {
+                    buffer.push_back(0xDB);
+                    write_big_endian((std::uint32_t)size);
+                }
+                break;
+            }
+            // Smallest integer length
+            case jsonh_binary_format::ubjson: {
+                if (size <= INT8_MAX) {
+                    buffer.push_back('i');
+                    write_big_endian((std::uint8_t)size);
+                }
+                else if (size <= UINT8_MAX) {
+                    buffer.push_back('U');
+                    write_big_endian((std::uint8_t)size);
+                }
+                else if (size <= INT16_MAX) {
+                    buffer.push_back('I');
+                    write_big_endian((std::uint16_t)size);
+                }
+                else if (size <= INT32_MAX) {
+                    buffer.push_back('l');
+                    write_big_endian((std::uint32_t)size);
+                }
+                else {
+                    buffer.push_back('L');
+                    write_big_endian((std::uint64_t)size);
+                }
+                break;
+            }
+            // Little-endian size including null terminator
+            case jsonh_binary_format::bson: {
+                uint32_t bson_size = (uint32_t)size + 1;
+                for (size_t index = 0; index < 4; index++) {
+                    buffer.push_back((std::uint8_t)(bson_size >> (index * 8)));
+                }
+                buffer.insert(buffer.end(), string.begin(), string.end());
+                buffer.push_back(0x00);
+                return;
+            }
+        }
+        buffer.insert(buffer.end(), string.begin(), string.end());
+    }
+    template <typename T>
+    void write_big_endian(T value) noexcept {
+        std::uint8_t bytes[sizeof(T)];
+        std::memcpy(bytes, &value, sizeof(T));
+        for (size_t index = 0; index < sizeof(T); index++) {
+            buffer.push_back(bytes[std::endian::native == std::endian::big ? index : sizeof(T) - 1 - index]);
+        }
+    }
+    static bool is_exact_float(double number) noexcept {
+        return number >= (double)std::numeric_limits<float>::lowest() && number <= (double)std::numeric_limits<float>::max()
+            && (double)(float)number == number;
+    }
+    static std::uint8_t bson_type(json_token_type type) noexcept {
+        switch (type) {
+            case json_token_type::number: return 0x01;
+            case json_token_type::string: return 0x02;
+            case json_token_type::true_bool: case json_token_type::false_bool: return 0x08;
+            default: return 0x0A;
+        }
+    }
+};
+
+}
@@ -0,0 +1,149 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+#include <system_error>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <functional>
+#include "martinmoene/expected.hpp"
+#include "nlohmann/json.hpp"
+#include "jsonh_reader.hpp"
+#include "jsonh_reader_options.hpp"
+#include "jsonh_version.hpp"
+#include "jsonh_little_endian.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief A cache that stores parsed JSONH documents as CBOR next to their source files.
+*
+* The cache file starts with a header containing the cache format version, the library version, the options that affect the parsed result
+* and a hash of the source, so it is rewritten whenever any of them change.
+**/
+class jsonh_cache {
+public:
+    /**
+    * @brief The version of the cache file format. Incremented whenever the header changes.
+    *
+    * Changes to the parsed result are covered by the library version (@ref jsonh_cpp_version), which is also in the header.
+    **/
+    static constexpr uint32_t format_version = 3;
+    /**
+    * @brief The extension appended to the source path to get the cache path.
+    **/
+    static constexpr const char* extension = ".jsonhc";
+
+    /**
+    * @brief Loads the JSONH file at the given path, using the cache file next to it if it is up to date.
+    *
+    * If the cache file is missing or outdated, the source is parsed and the cache file is rewritten.
+    * Failing to write the cache file is not an error.
+    **/
+    static nonstd::expected<json, std::string> load(const std::filesystem::path& path, jsonh_reader_options options = jsonh_reader_options()) noexcept {
+        // Read source
+        std::ifstream source_stream(path, std::ios::binary);
+        if (!source_stream) {
+            return nonstd::unexpected<std::string>("Failed to open file: " + path.string());
+        }
+        std::string source((std::istreambuf_iterator<char>(source_stream)), std::istreambuf_iterator<char>());
+        std::vector<std::uint8_t> header = create_header(source, options);
+
+        // Read cache
+        std::filesystem::path cache = cache_path(path);
+        std::ifstream cache_stream(cache, std::ios::binary);
+        if (cache_stream) {
+            std::vector<std::uint8_t> cache_bytes((std::istreambuf_iterator<char>(cache_stream)), std::istreambuf_iterator<char>());
+            if (cache_bytes.size() > header.size() && std::equal(header.begin(), header.end(), cache_bytes.begin())) {
+                json element = json::from_cbor(cache_bytes.begin() + header.size(), cache_bytes.end(), true, false);
+                if (!element.is_discarded()) {
+                    return element;
+                }
+            }
+        }
+        cache_stream.close();
+
+        // Parse source
+        nonstd::expected<json, std::string> element = jsonh_reader(source, options).parse_element();
+        if (!element) {
+            return element;
+        }
+
+        // Write cache
+        std::vector<std::uint8_t> cache_bytes = header;
+        json::to_cbor(element.value(), cache_bytes);
+        write_cache(cache, cache_bytes);
+
+        return element;
+    }
+    /**
+    * @brief Returns the path of the cache file for the given JSONH file.
+    **/
+    static std::filesystem::path cache_path(const std::filesystem::path& path) noexcept {
+        std::filesystem::path cache = path;
+        cache += extension;
+        return cache;
+    }
+
+private:
+    static std::vector<std::uint8_t> create_header(const std::string& source, const jsonh_reader_options& options) noexcept {
+        std::vector<std::uint8_t> header = { 'J', 'S', 'O', 'N', 'H', 'C' };
+
+        // Format version
+        jsonh_little_endian::write_integer(header, format_version, 4);
+        // Library version
+        jsonh_little_endian::write_integer(header, jsonh_cpp_version.size(), 4);
+        header.insert(header.end(), jsonh_cpp_version.begin(), jsonh_cpp_version.end());
+        // Options
+        header.push_back((std::uint8_t)options.version);
+        header.push_back(options.parse_single_element ? 1 : 0);
+        header.push_back(options.incomplete_inputs ? 1 : 0);
+        jsonh_little_endian::write_integer(header, (uint32_t)options.max_depth, 4);
+        header.push_back((std::uint8_t)options.duplicate_property_policy);
+        // skip_comments and max_diagnostics are not keyed since they never change the result (comments are always skipped when parsing elements, and diagnostics are not collected)
+        // Source size and hash
+        jsonh_little_endian::write_integer(header, source.size(), 8);
+        jsonh_little_endian::write_integer(header, jsonh_semantic_hasher::hash_bytes(source), 8);
+
+        return header;
+    }
+    static uint64_t unique_id() noexcept {
+        // Thread, time and counter (distinguishes writers in other threads, other processes and this thread)
+        static std::atomic<uint64_t> counter = 0;
+        uint64_t id = std::hash<std::thread::id>()(std::this_thread::get_id());
+        id ^= (uint64_t)std::chrono::high_resolution_clock::now().time_since_epoch().count() * 0x9E3779B97F4A7C15ull;
+        id ^= counter.fetch_add(1) << 48;
+        return id;
+    }
+    static void write_cache(const std::filesystem::path& cache, const std::vector<std::uint8_t>& cache_bytes) noexcept {
+        // Write to temporary file and replace so readers never see a partial cache (unique per writer so concurrent writers don't overwrite each other)
+        std::filesystem::path temporary = cache;
+        temporary += ".tmp" + std::to_string(unique_id());
+        {
+            std::ofstream cache_stream(temporary, std::ios::binary | std::ios::trunc);
+            if (!cache_stream) {
+                return;
+            }
+            cache_stream.write((const char*)cache_bytes.data(), cache_bytes.size());
+            if (!cache_stream) {
+                cache_stream.close();
+                std::error_code error;
+                std::filesystem::remove(temporary, error);
+                return;
+            }
+        }
+        std::error_code error;
+        std::filesystem::rename(temporary, cache, error);
+        if (error) {
+            std::filesystem::remove(temporary, error);
+        }
+    }
+};
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "martinmoene/expected.hpp"
+#include "jsonh_little_endian.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief The state of a @ref jsonh_reader between elements or between array items, used to resume reading the same input later.
+**/
+struct jsonh_checkpoint {
+    /**
+    * @brief The version of the checkpoint format.
+    **/
+    static constexpr uint32_t format_version = 1;
+
+    /**
+    * @brief The byte position of the reader.
+    **/
+    size_t position = 0;
+    /**
+    * @brief The recursion depth of the reader.
+    **/
+    int32_t depth = 0;
+    /**
+    * @brief Whether the reader is between the items of an array read by @ref jsonh_reader::parse_items.
+    **/
+    bool is_in_items = false;
+    /**
+    * @brief The number of items of the array already read by @ref jsonh_reader::parse_items.
+    **/
+    size_t item_count = 0;
+
+    /**
+    * @brief Serializes the checkpoint to bytes.
+    **/
+    std::vector<std::uint8_t> to_bytes() const noexcept {
+        std::vector<std::uint8_t> bytes = { 'J', 'S', 'O', 'N', 'H', 'K' };
+        jsonh_little_endian::write_integer(bytes, format_version);
+        jsonh_little_endian::write_integer(bytes, position);
+        jsonh_little_endian::write_integer(bytes, (uint32_t)depth);
+        jsonh_little_endian::write_integer(bytes, is_in_items ? 1 : 0);
+        jsonh_little_endian::write_integer(bytes, item_count);
+        return bytes;
+    }
+    /**
+    * @brief Deserializes a checkpoint from bytes created by @ref to_bytes.
+    **/
+    static nonstd::expected<jsonh_checkpoint, std::string> from_bytes(const std::vector<std::uint8_t>& bytes) noexcept {
+        size_t offset = 6;
+        if (bytes.size() != offset + (5 * 8) || std::string(bytes.begin(), bytes.begin() + offset) != "JSONHK") {
+            return nonstd::unexpected<std::string>("Expected JSONH checkpoint");
+        }
+        uint64_t value = 0;
+        if (!jsonh_little_endian::read_integer(bytes, offset, value) || value != format_version) {
+            return nonstd::unexpected<std::string>("Unsupported JSONH checkpoint version");
+        }
+
+        // Fields (the length is already checked)
+        jsonh_checkpoint checkpoint;
+        jsonh_little_endian::read_integer(bytes, offset, value);
+        checkpoint.position = (size_t)value;
+        jsonh_little_endian::read_integer(bytes, offset, value);
+        checkpoint.depth = (int32_t)(uint32_t)value;
+        jsonh_little_endian::read_integer(bytes, offset, value);
+        checkpoint.is_in_items = value != 0;
+        jsonh_little_endian::read_integer(bytes, offset, value);
+        checkpoint.item_count = (size_t)value;
+        return checkpoint;
+    }
+};
+
+}
@@ -1,3 +1,6 @@
 #pragma once
 
-#include "jsonh_reader.hpp"
\ No newline at end of file
+#include "jsonh_reader.hpp"
+#include "jsonh_cache.hpp"
+#include "jsonh_line_lexer.hpp"
+#include "jsonh_document.hpp"
\ No newline at end of file
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <string>
+#include <cstddef>
+
+namespace jsonh_cpp {
+
+/**
+* @brief An error that the reader recovered from while parsing.
+**/
+struct jsonh_diagnostic {
+    /**
+    * @brief The error message.
+    **/
+    std::string message;
+    /**
+    * @brief The byte position in the input where the error occurred.
+    **/
+    size_t position = 0;
+    /**
+    * @brief The line number where the error occurred, starting at 1.
+    **/
+    size_t line = 0;
+    /**
+    * @brief The column number (in runes) where the error occurred, starting at 1.
+    **/
+    size_t column = 0;
+};
+
+}
@@ -0,0 +1,343 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+#include <cstdint>
+#include <cstddef>
+#include "martinmoene/expected.hpp"
+#include "nlohmann/json.hpp"
+#include "jsonh_reader.hpp"
+#include "jsonh_reader_options.hpp"
+#include "jsonh_element_location.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief A parsed JSONH document that can be edited and reparsed incrementally.
+*
+* The document keeps the input, the parsed element and the location of each element.
+* After an edit, only the innermost element containing the edit is reparsed and spliced into the parsed element,
+* falling back to its enclosing elements and then to the whole input if the edit changes the extent of the element.
+**/
+class jsonh_document {
+public:
+    /**
+    * @brief A replacement of a byte range of the input.
+    **/
+    struct edit {
+        /**
+        * @brief The byte position of the start of the replaced range.
+        **/
+        size_t position = 0;
+        /**
+        * @brief The number of bytes replaced.
+        **/
+        size_t length = 0;
+        /**
+        * @brief The text to insert in place of the replaced range.
+        **/
+        std::string text;
+    };
+
+    /**
+    * @brief The options to use when parsing the document.
+    **/
+    jsonh_reader_options options;
+
+    /**
+    * @brief Parses a document from a UTF-8 string.
+    **/
+    static nonstd::expected<jsonh_document, std::string> parse(std::string input, jsonh_reader_options options = jsonh_reader_options()) noexcept {
+        jsonh_document document = jsonh_document(std::move(input), options);
+        nonstd::expected<void, std::string> parse_result = document.parse_input();
+        if (!parse_result) {
+            return nonstd::unexpected<std::string>(parse_result.error());
+        }
+        return document;
+    }
+
+    /**
+    * @brief Returns the current input, including edits that could not be parsed.
+    **/
+    const std::string& input() const noexcept {
+        return current_input;
+    }
+    /**
+    * @brief Returns the parsed element from the last input that could be parsed.
+    **/
+    const json& element() const noexcept {
+        return current_element;
+    }
+    /**
+    * @brief Returns the location of each element in @ref element, in pre-order.
+    **/
+    const std::vector<jsonh_element_location>& locations() const noexcept {
+        return current_locations;
+    }
+    /**
+    * @brief Returns whether @ref element matches @ref input (false after an edit that could not be parsed).
+    **/
+    bool is_valid() const noexcept {
+        return current_is_valid;
+    }
+
+    /**
+    * @brief Applies an edit to the input and reparses the affected elements.
+    *
+    * If the new input cannot be parsed, the edit is still applied to @ref input but @ref element is unchanged and the error is returned.
+    * The next edit then reparses the whole input.
+    **/
+    nonstd::expected<void, std::string> apply_edit(const edit& next_edit) noexcept {
+        if (next_edit.position > current_input.size() || next_edit.length > current_input.size() - next_edit.position) {
+            return nonstd::unexpected<std::string>("Edit out of range of input");
+        }
+
+        // Reparse innermost element containing edit
+        if (current_is_valid && reparse_element(next_edit)) {
+            return nonstd::expected<void, std::string>(); // Success
+        }
+
+        // Reparse whole input
+        current_input.replace(next_edit.position, next_edit.length, next_edit.text);
+        return parse_input();
+    }
+    /**
+    * @brief Applies each edit in order. The position of each edit is in the input after the previous edits.
+    *
+    * Stops at the first edit that fails (see @ref apply_edit) and returns its error, so the following edits are not applied.
+    **/
+    nonstd::expected<void, std::string> apply_edits(std::span<const edit> edits) noexcept {
+        for (const edit& next_edit : edits) {
+            nonstd::expected<void, std::string> result = apply_edit(next_edit);
+            if (!result) {
+                return result;
+            }
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+
+private:
+    std::string current_input;
+    json current_element;
+    std::vector<jsonh_element_location> current_locations;
+    bool current_is_valid = false;
+
+    explicit jsonh_document(std::string input, jsonh_reader_options options) noexcept
+        : options(options), current_input(std::move(input)) {
+    }
+
+    nonstd::expected<void, std::string> parse_input() noexcept {
+        std::vector<jsonh_element_location> locations;
+        nonstd::expected<json, std::string> element = jsonh_reader(current_input, options).parse_element(locations);
+        if (!element) {
+            current_is_valid = false;
+            return nonstd::unexpected<std::string>(element.error());
+        }
+        current_element = std::move(element.value());
+        current_locations = std::move(locations);
+        current_is_valid = true;
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    bool reparse_element(const edit& next_edit) noexcept {
+        size_t edit_end = next_edit.position + next_edit.length;
+
+        // Find elements strictly containing edit (from outermost to innermost, excluding root)
+        std::vector<size_t> candidate_indexes;
+        for (size_t index = 1; index < current_locations.size(); index++) {
+            const jsonh_element_location& location = current_locations[index];
+            if (location.position >= edit_end) {
+                break;
+            }
+            if (location.position < next_edit.position && edit_end < location.position + location.length) {
+                candidate_indexes.push_back(index);
+            }
+        }
+
+        // Try innermost first
+        for (size_t candidate = candidate_indexes.size(); candidate-- > 0;) {
+            size_t parent_index = candidate > 0 ? candidate_indexes[candidate - 1] : 0;
+            if (reparse_element_at(candidate_indexes[candidate], parent_index, next_edit)) {
+                return true;
+            }
+        }
+        return false;
+    }
+    bool reparse_element_at(size_t location_index, size_t parent_index, const edit& next_edit) noexcept {
+        const jsonh_element_location location = current_locations[location_index];
+        std::ptrdiff_t length_change = (std::ptrdiff_t)next_edit.text.size() - (std::ptrdiff_t)next_edit.length;
+        size_t new_length = location.length + length_change;
+
+        // Element must have a unique pointer (not a duplicate property)
+        const jsonh_element_location& parent_location = current_locations[parent_index];
+        if (options.duplicate_property_policy != jsonh_duplicate_property_policy::error && current_input[parent_location.position] != '[') {
+            for (size_t index = parent_index + 1; index < current_locations.size() && current_locations[index].position < parent_location.position + parent_location.length; index++) {
+                if (index != location_index && current_locations[index].pointer == location.pointer) {
+                    return false;
+                }
+            }
+        }
+
+        // Build new text of element
+        std::string_view old_text = std::string_view(current_input).substr(location.position, location.length);
+        std::string new_text;
+        new_text.reserve(new_length);
+        new_text.append(old_text.substr(0, next_edit.position - location.position));
+        new_text.append(next_edit.text);
+        new_text.append(old_text.substr(next_edit.position + next_edit.length - location.position));
+
+        // Parse element with remaining depth
+        jsonh_reader_options element_options = options;
+        element_options.max_depth -= (int)count_reference_tokens(location.pointer);
+        element_options.parse_single_element = true;
+        element_options.incomplete_inputs = false;
+        std::vector<jsonh_element_location> new_locations;
+        nonstd::expected<json, std::string> new_element = jsonh_reader(new_text, element_options).parse_element(new_locations);
+        if (!new_element) {
+            return false;
+        }
+        // Element must have the same extent
+        if (new_locations.empty() || new_locations[0].position != 0 || new_locations[0].length != new_length) {
+            return false;
+        }
+        // Element must not become a braceless object
+        if (new_element.value().is_object() && new_text[0] != '{') {
+            return false;
+        }
+
+        // Count newlines before replacing input
+        std::ptrdiff_t line_change = (std::ptrdiff_t)count_newlines(new_text) - (std::ptrdiff_t)count_newlines(old_text);
+
+        // Replace input and element
+        current_input.replace(next_edit.position, next_edit.length, next_edit.text);
+        current_element[location.pointer] = std::move(new_element.value());
+
+        // Resize enclosing elements
+        for (size_t index = 0; index < location_index; index++) {
+            jsonh_element_location& enclosing_location = current_locations[index];
+            if (enclosing_location.position <= location.position && enclosing_location.position + enclosing_location.length >= location.position + location.length) {
+                enclosing_location.length += length_change;
+            }
+        }
+
+        // Replace locations of element and its descendants
+        size_t old_end_index = location_index + 1;
+        while (old_end_index < current_locations.size() && current_locations[old_end_index].position < location.position + location.length) {
+            old_end_index++;
+        }
+        for (jsonh_element_location& new_location : new_locations) {
+            new_location.pointer = location.pointer / new_location.pointer;
+            new_location.position += location.position;
+            if (new_location.line == 1) {
+                new_location.column += location.column - 1;
+            }
+            new_location.line += location.line - 1;
+        }
+        size_t new_end_index = location_index + new_locations.size();
+        size_t replaced_count = std::min(old_end_index, new_end_index) - location_index;
+        std::move(new_locations.begin(), new_locations.begin() + replaced_count, current_locations.begin() + location_index);
+        if (new_end_index > old_end_index) {
+            current_locations.insert(current_locations.begin() + old_end_index, std::make_move_iterator(new_locations.begin() + replaced_count), std::make_move_iterator(new_locations.end()));
+        }
+        else {
+            current_locations.erase(current_locations.begin() + new_end_index, current_locations.begin() + old_end_index);
+        }
+
+        // Move following locations
+        size_t element_end = location.position + new_length;
+        size_t line_end = find_line_end(element_end);
+        for (size_t index = new_end_index; index < current_locations.size(); index++) {
+            jsonh_element_location& following_location = current_locations[index];
+            following_location.position += length_change;
+            following_location.line += line_change;
+
+            // Recount column on same line as end of element
+            if (following_location.position < line_end) {
+                following_location.column = count_column(following_location.position);
+            }
+            // Only columns changed
+            else if (length_change == 0 && line_change == 0) {
+                break;
+            }
+        }
+
+        return true;
+    }
+    static size_t count_reference_tokens(const json::json_pointer& pointer) noexcept {
+        size_t count = 0;
+        json::json_pointer parent = pointer;
+        while (!parent.empty()) {
+            parent.pop_back();
+            count++;
+        }
+        return count;
+    }
+    static size_t count_newlines(std::string_view text) noexcept {
+        size_t count = 0;
+        for (size_t index = 0; index < text.size(); index++) {
+            switch ((std::uint8_t)text[index]) {
+                // Line feed
+                case '\n': {
+                    count++;
+                    break;
+                }
+                // Carriage return (join CR LF)
+                case '\r': {
+                    if (index + 1 >= text.size() || text[index + 1] != '\n') {
+                        count++;
+                    }
+                    break;
+                }
+                // Line separator / paragraph separator
+                case 0xE2: {
+                    if (index + 2 < text.size() && (std::uint8_t)text[index + 1] == 0x80 && ((std::uint8_t)text[index + 2] == 0xA8 || (std::uint8_t)text[index + 2] == 0xA9)) {
+                        count++;
+                        index += 2;
+                    }
+                    break;
+                }
+            }
+        }
+        return count;
+    }
+    size_t find_line_end(size_t position) const noexcept {
+        for (; position < current_input.size(); position++) {
+            std::uint8_t next = (std::uint8_t)current_input[position];
+            if (next == '\n' || next == '\r' || (next == 0xE2 && is_separator_at(position))) {
+                break;
+            }
+        }
+        return position;
+    }
+    size_t count_column(size_t position) const noexcept {
+        // Find start of line
+        size_t line_start = position;
+        while (line_start > 0) {
+            std::uint8_t previous = (std::uint8_t)current_input[line_start - 1];
+            if (previous == '\n' || previous == '\r' || (line_start >= 3 && previous >= 0xA8 && previous <= 0xA9 && is_separator_at(line_start - 3))) {
+                break;
+            }
+            line_start--;
+        }
+
+        // Count runes
+        size_t column = 1;
+        for (size_t index = line_start; index < position; index++) {
+            if (((std::uint8_t)current_input[index] & 0xC0) != 0x80) {
+                column++;
+            }
+        }
+        return column;
+    }
+    bool is_separator_at(size_t position) const noexcept {
+        // Line separator / paragraph separator
+        return position + 2 < current_input.size() && (std::uint8_t)current_input[position] == 0xE2 && (std::uint8_t)current_input[position + 1] == 0x80
+            && ((std::uint8_t)current_input[position + 2] == 0xA8 || (std::uint8_t)current_input[position + 2] == 0xA9);
+    }
+};
+
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+
+namespace jsonh_cpp {
+
+/**
+* @brief The ways to handle an object containing multiple properties with the same name.
+**/
+enum struct jsonh_duplicate_property_policy : uint8_t {
+    /**
+    * @brief The last property with the name is used.
+    **/
+    last_wins = 0,
+    /**
+    * @brief The first property with the name is used.
+    **/
+    first_wins = 1,
+    /**
+    * @brief An error is returned.
+    **/
+    error = 2,
+    /**
+    * @brief The values of the properties with the name are collected into an array in input order.
+    **/
+    collect = 3,
+};
+
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include "nlohmann/json.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief The location of a parsed element in the input.
+**/
+struct jsonh_element_location {
+    /**
+    * @brief The JSON pointer to the element in the parsed result.
+    **/
+    nlohmann::json::json_pointer pointer;
+    /**
+    * @brief The byte position of the start of the element in the input.
+    **/
+    size_t position = 0;
+    /**
+    * @brief The number of bytes the element spans in the input.
+    **/
+    size_t length = 0;
+    /**
+    * @brief The line number of the start of the element, starting at 1.
+    **/
+    size_t line = 0;
+    /**
+    * @brief The column number (in runes) of the start of the element, starting at 1.
+    **/
+    size_t column = 0;
+};
+
+}
\ No newline at end of file
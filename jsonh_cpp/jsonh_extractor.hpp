@@ -0,0 +1,195 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <utility>
+#include <algorithm>
+#include <limits>
+#include <cstddef>
+#include "martinmoene/expected.hpp"
+#include "nlohmann/json.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief A compiled plan that extracts a fixed set of paths from each element in a single pass.
+*
+* The paths are JSON pointers (e.g. @c /user/name or @c /tags/0) compiled into a trie, so the plan can be reused for any number of elements.
+* Each path is extracted into the slot with the same index as the path.
+**/
+struct jsonh_extractor {
+    /**
+    * @brief A node of the trie, matching one reference token of a path.
+    **/
+    struct node {
+        /**
+        * @brief The reference tokens of the child nodes and their indexes in @ref nodes, sorted by reference token.
+        **/
+        std::vector<std::pair<std::string, size_t>> children;
+        /**
+        * @brief The index of the slot extracted at this node, or @ref no_slot.
+        **/
+        size_t slot = no_slot;
+    };
+
+    /**
+    * @brief The slot of a node that is not the end of a path.
+    **/
+    static constexpr size_t no_slot = std::numeric_limits<size_t>::max();
+    /**
+    * @brief The child of a node that does not match a reference token.
+    **/
+    static constexpr size_t no_node = std::numeric_limits<size_t>::max();
+
+    /**
+    * @brief The nodes of the trie, starting with the root node.
+    **/
+    std::vector<node> nodes = { node() };
+    /**
+    * @brief The number of paths.
+    **/
+    size_t slot_count = 0;
+
+    /**
+    * @brief Compiles the paths (JSON pointers) into an extractor.
+    **/
+    static nonstd::expected<jsonh_extractor, std::string> compile(const std::vector<std::string>& paths) noexcept {
+        jsonh_extractor extractor;
+        for (const std::string& path : paths) {
+            // Add nodes for each reference token
+            size_t node_index = 0;
+            size_t index = 0;
+            while (index < path.size()) {
+                if (path[index] != '/') {
+                    return nonstd::unexpected<std::string>("Expected `/` in extractor path");
+                }
+                index++;
+
+                // Unescape reference token
+                std::string reference_token;
+                for (; index < path.size() && path[index] != '/'; index++) {
+                    if (path[index] != '~') {
+                        reference_token += path[index];
+                    }
+                    else if (index + 1 < path.size() && (path[index + 1] == '0' || path[index + 1] == '1')) {
+                        reference_token += path[index + 1] == '0' ? '~' : '/';
+                        index++;
+                    }
+                    else {
+                        return nonstd::unexpected<std::string>("Invalid escape in extractor path");
+                    }
+                }
+
+                // Find or add child node
+                std::vector<std::pair<std::string, size_t>>& children = extractor.nodes[node_index].children;
+                std::vector<std::pair<std::string, size_t>>::iterator child = std::lower_bound(children.begin(), children.end(), reference_token,
+                    [](const std::pair<std::string, size_t>& child, const std::string& name) { return child.first < name; });
+                if (child == children.end() || child->first != reference_token) {
+                    size_t child_index = extractor.nodes.size();
+                    children.emplace(child, std::move(reference_token), child_index);
+                    extractor.nodes.push_back(node());
+                    node_index = child_index;
+                }
+                else {
+                    node_index = child->second;
+                }
+            }
+
+            // Assign slot to last node
+            if (extractor.nodes[node_index].slot != no_slot) {
+                return nonstd::unexpected<std::string>("Duplicate extractor path: " + path);
+            }
+            extractor.nodes[node_index].slot = extractor.slot_count;
+            extractor.slot_count++;
+        }
+        return extractor;
+    }
+
+    /**
+    * @brief Returns the index of the child of the node matching the reference token, or @ref no_node.
+    **/
+    size_t find_child(size_t node_index, std::string_view reference_token) const noexcept {
+        const std::vector<std::pair<std::string, size_t>>& children = nodes[node_index].children;
+        std::vector<std::pair<std::string, size_t>>::const_iterator child = std::lower_bound(children.begin(), children.end(), reference_token,
+            [](const std::pair<std::string, size_t>& child, std::string_view name) { return child.first < name; });
+        if (child == children.end() || child->first != reference_token) {
+            return no_node;
+        }
+        return child->second;
+    }
+    /**
+    * @brief Clears the slots of the node and its descendants, counting up the slots left to fill.
+    **/
+    void clear(size_t node_index, std::vector<std::optional<nlohmann::json>>& slots, size_t& remaining_count) const noexcept {
+        const node& current_node = nodes[node_index];
+        if (current_node.slot != no_slot && slots[current_node.slot]) {
+            slots[current_node.slot].reset();
+            remaining_count++;
+        }
+        for (const std::pair<std::string, size_t>& child : current_node.children) {
+            clear(child.second, slots, remaining_count);
+        }
+    }
+    /**
+    * @brief Extracts the paths from a parsed element into the slots and returns the number of slots filled.
+    *
+    * Slots whose path is not found are @c std::nullopt.
+    **/
+    size_t run(const nlohmann::json& element, std::vector<std::optional<nlohmann::json>>& slots) const noexcept {
+        slots.assign(slot_count, std::nullopt);
+        size_t remaining_count = slot_count;
+        run(element, 0, slots, remaining_count);
+        return slot_count - remaining_count;
+    }
+    /**
+    * @brief Extracts the paths below the node from a parsed element into the slots, counting down the slots left to fill.
+    **/
+    void run(const nlohmann::json& element, size_t node_index, std::vector<std::optional<nlohmann::json>>& slots, size_t& remaining_count) const noexcept {
+        const node& current_node = nodes[node_index];
+
+        // Fill slot
+        if (current_node.slot != no_slot && !slots[current_node.slot]) {
+            slots[current_node.slot] = element;
+            remaining_count--;
+        }
+
+        // Object
+        if (element.is_object()) {
+            for (const std::pair<std::string, size_t>& child : current_node.children) {
+                nlohmann::json::const_iterator property = element.find(child.first);
+                if (property != element.end()) {
+                    run(property.value(), child.second, slots, remaining_count);
+                }
+            }
+        }
+        // Array
+        else if (element.is_array()) {
+            for (const std::pair<std::string, size_t>& child : current_node.children) {
+                std::optional<size_t> item_index = to_item_index(child.first);
+                if (item_index && item_index.value() < element.size()) {
+                    run(element[item_index.value()], child.second, slots, remaining_count);
+                }
+            }
+        }
+    }
+
+private:
+    static std::optional<size_t> to_item_index(std::string_view reference_token) noexcept {
+        // Digits without leading zeroes
+        if (reference_token.empty() || (reference_token.size() > 1 && reference_token[0] == '0')) {
+            return std::nullopt;
+        }
+        size_t item_index = 0;
+        for (char next : reference_token) {
+            if (next < '0' || next > '9' || item_index > (std::numeric_limits<size_t>::max() - 9) / 10) {
+                return std::nullopt;
+            }
+            item_index = item_index * 10 + (size_t)(next - '0');
+        }
+        return item_index;
+    }
+};
+
+}
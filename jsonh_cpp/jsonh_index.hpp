@@ -0,0 +1,185 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <fstream>
+#include <iterator>
+#include <filesystem>
+#include "martinmoene/expected.hpp"
+#include "jsonh_little_endian.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief An index of byte positions in the root element of a JSONH input, used to seek to properties and items without reading from the start.
+*
+* Every position is at depth 1 of the root element, so reading can resume from it without any other state.
+**/
+struct jsonh_index {
+    /**
+    * @brief A property of the root object.
+    **/
+    struct property {
+        /**
+        * @brief The name of the property.
+        **/
+        std::string name;
+        /**
+        * @brief The byte position of the start of the property value.
+        **/
+        size_t position = 0;
+    };
+
+    /**
+    * @brief The version of the index file format.
+    **/
+    static constexpr uint32_t format_version = 3;
+
+    /**
+    * @brief Whether the root element is an array.
+    **/
+    bool is_array = false;
+    /**
+    * @brief The properties of the root object, sorted by name (properties with the same name are kept in input order).
+    **/
+    std::vector<property> properties;
+    /**
+    * @brief The number of items between each position in @ref item_positions.
+    **/
+    size_t item_interval = 1;
+    /**
+    * @brief The byte positions of the start of every @ref item_interval items of the root array, starting with the first item.
+    **/
+    std::vector<size_t> item_positions;
+    /**
+    * @brief The number of items in the root array.
+    **/
+    size_t item_count = 0;
+    /**
+    * @brief The size of the whole input in bytes, used with @ref input_hash to reject the index for a different input.
+    **/
+    size_t input_size = 0;
+    /**
+    * @brief The FNV-1a hash of the whole input, used with @ref input_size to reject the index for a different input.
+    **/
+    uint64_t input_hash = 0;
+
+    /**
+    * @brief Serializes the index to bytes.
+    **/
+    std::vector<std::uint8_t> to_bytes() const noexcept {
+        std::vector<std::uint8_t> bytes = { 'J', 'S', 'O', 'N', 'H', 'I' };
+        jsonh_little_endian::write_integer(bytes, format_version);
+        jsonh_little_endian::write_integer(bytes, is_array ? 1 : 0);
+        jsonh_little_endian::write_integer(bytes, input_size);
+        jsonh_little_endian::write_integer(bytes, input_hash);
+
+        // Properties
+        jsonh_little_endian::write_integer(bytes, properties.size());
+        for (const property& next_property : properties) {
+            jsonh_little_endian::write_integer(bytes, next_property.name.size());
+            bytes.insert(bytes.end(), next_property.name.begin(), next_property.name.end());
+            jsonh_little_endian::write_integer(bytes, next_property.position);
+        }
+
+        // Items
+        jsonh_little_endian::write_integer(bytes, item_interval);
+        jsonh_little_endian::write_integer(bytes, item_count);
+        jsonh_little_endian::write_integer(bytes, item_positions.size());
+        for (size_t item_position : item_positions) {
+            jsonh_little_endian::write_integer(bytes, item_position);
+        }
+        return bytes;
+    }
+    /**
+    * @brief Deserializes an index from bytes created by @ref to_bytes.
+    **/
+    static nonstd::expected<jsonh_index, std::string> from_bytes(const std::vector<std::uint8_t>& bytes) noexcept {
+        size_t offset = 6;
+        if (bytes.size() < offset || std::string(bytes.begin(), bytes.begin() + offset) != "JSONHI") {
+            return nonstd::unexpected<std::string>("Expected JSONH index");
+        }
+        jsonh_index index;
+        uint64_t value = 0;
+
+        // Header
+        if (!jsonh_little_endian::read_integer(bytes, offset, value) || value != format_version) {
+            return nonstd::unexpected<std::string>("Unsupported JSONH index version");
+        }
+        if (!jsonh_little_endian::read_integer(bytes, offset, value)) {
+            return nonstd::unexpected<std::string>("Expected JSONH index header, got end of input");
+        }
+        index.is_array = value != 0;
+        if (!jsonh_little_endian::read_integer(bytes, offset, value)) {
+            return nonstd::unexpected<std::string>("Expected JSONH index header, got end of input");
+        }
+        index.input_size = (size_t)value;
+        if (!jsonh_little_endian::read_integer(bytes, offset, index.input_hash)) {
+            return nonstd::unexpected<std::string>("Expected JSONH index header, got end of input");
+        }
+
+        // Properties
+        uint64_t property_count = 0;
+        if (!jsonh_little_endian::read_integer(bytes, offset, property_count)) {
+            return nonstd::unexpected<std::string>("Expected JSONH index properties, got end of input");
+        }
+        for (uint64_t property_index = 0; property_index < property_count; property_index++) {
+            property next_property;
+            if (!jsonh_little_endian::read_integer(bytes, offset, value) || value > bytes.size() - offset) {
+                return nonstd::unexpected<std::string>("Expected JSONH index property, got end of input");
+            }
+            next_property.name.assign(bytes.begin() + offset, bytes.begin() + offset + (size_t)value);
+            offset += (size_t)value;
+            if (!jsonh_little_endian::read_integer(bytes, offset, value)) {
+                return nonstd::unexpected<std::string>("Expected JSONH index property, got end of input");
+            }
+            next_property.position = (size_t)value;
+            index.properties.push_back(std::move(next_property));
+        }
+
+        // Items
+        uint64_t item_position_count = 0;
+        if (!jsonh_little_endian::read_integer(bytes, offset, value) || value == 0) {
+            return nonstd::unexpected<std::string>("Expected JSONH index items, got end of input");
+        }
+        index.item_interval = (size_t)value;
+        if (!jsonh_little_endian::read_integer(bytes, offset, value) || !jsonh_little_endian::read_integer(bytes, offset, item_position_count)) {
+            return nonstd::unexpected<std::string>("Expected JSONH index items, got end of input");
+        }
+        index.item_count = (size_t)value;
+        for (uint64_t item_index = 0; item_index < item_position_count; item_index++) {
+            if (!jsonh_little_endian::read_integer(bytes, offset, value)) {
+                return nonstd::unexpected<std::string>("Expected JSONH index item, got end of input");
+            }
+            index.item_positions.push_back((size_t)value);
+        }
+        return index;
+    }
+    /**
+    * @brief Writes the index to a file.
+    **/
+    nonstd::expected<void, std::string> save(const std::filesystem::path& path) const noexcept {
+        std::ofstream stream(path, std::ios::binary | std::ios::trunc);
+        std::vector<std::uint8_t> bytes = to_bytes();
+        stream.write((const char*)bytes.data(), bytes.size());
+        if (!stream) {
+            return nonstd::unexpected<std::string>("Failed to write file: " + path.string());
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    /**
+    * @brief Reads an index from a file written by @ref save.
+    **/
+    static nonstd::expected<jsonh_index, std::string> load(const std::filesystem::path& path) noexcept {
+        std::ifstream stream(path, std::ios::binary);
+        if (!stream) {
+            return nonstd::unexpected<std::string>("Failed to open file: " + path.string());
+        }
+        std::vector<std::uint8_t> bytes((std::istreambuf_iterator<char>(stream)), std::istreambuf_iterator<char>());
+        return from_bytes(bytes);
+    }
+};
+
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+#include "jsonh_lexeme_type.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief A span of a line found by @ref jsonh_line_lexer, without a decoded value.
+**/
+struct jsonh_lexeme {
+    /**
+    * @brief The type of the lexeme.
+    **/
+    jsonh_lexeme_type type = jsonh_lexeme_type::invalid;
+    /**
+    * @brief The byte position of the start of the lexeme in the line.
+    **/
+    size_t position = 0;
+    /**
+    * @brief The number of bytes the lexeme spans in the line.
+    **/
+    size_t length = 0;
+};
+
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include <cstdint>
+
+namespace jsonh_cpp {
+
+/**
+* @brief The types of lexemes found by @ref jsonh_line_lexer.
+**/
+enum struct jsonh_lexeme_type : uint8_t {
+    /**
+    * @brief A character that is not valid at its position.
+    **/
+    invalid = 0,
+    /**
+    * @brief The start of an object.
+    *
+    * Example: @c {
+    **/
+    start_object = 1,
+    /**
+    * @brief The end of an object.
+    *
+    * Example: @c }
+    **/
+    end_object = 2,
+    /**
+    * @brief The start of an array.
+    *
+    * Example: @c [
+    **/
+    start_array = 3,
+    /**
+    * @brief The end of an array.
+    *
+    * Example: @c ]
+    **/
+    end_array = 4,
+    /**
+    * @brief A comma between properties or items.
+    *
+    * Example: @c ,
+    **/
+    comma = 5,
+    /**
+    * @brief A colon after a property name.
+    *
+    * Example: @c :
+    **/
+    colon = 6,
+    /**
+    * @brief A property name (a string followed by a colon on the same line).
+    *
+    * Example: @c "key"
+    **/
+    property_name = 7,
+    /**
+    * @brief A comment or part of a block comment.
+    *
+    * Example: @c //comment
+    **/
+    comment = 8,
+    /**
+    * @brief A quoted or quoteless string or part of a multi-line string.
+    *
+    * Example: @c "value"
+    **/
+    string = 9,
+    /**
+    * @brief A number.
+    *
+    * Example: @c 10
+    **/
+    number = 10,
+    /**
+    * @brief A true boolean.
+    *
+    * Example: @c true
+    **/
+    true_bool = 11,
+    /**
+    * @brief A false boolean.
+    *
+    * Example: @c false
+    **/
+    false_bool = 12,
+    /**
+    * @brief A null value.
+    *
+    * Example: @c null
+    **/
+    null = 13,
+};
+
+}
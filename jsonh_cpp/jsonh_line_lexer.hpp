@@ -0,0 +1,519 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <optional>
+#include <cstdint>
+#include <cstddef>
+#include "jsonh_lexeme.hpp"
+#include "jsonh_lexeme_type.hpp"
+#include "jsonh_reader_options.hpp"
+#include "jsonh_version.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief A lexer that finds the lexemes of JSONH one line at a time without decoding values, intended for editors and syntax highlighting.
+*
+* The lexer state at the start of each line is small and comparable, so after an edit, lexing can restart from the first changed line
+* and stop as soon as the state at the start of a line matches the state before the edit (see @ref relex).
+*
+* Lines are split at @c \\n, @c \\r\\n or @c \\r. Property names are only recognised when the colon is on the same line.
+**/
+class jsonh_line_lexer {
+public:
+    /**
+    * @brief The state of the lexer at the start of a line.
+    **/
+    struct state {
+        /**
+        * @brief The types of lexemes that can continue onto the next line.
+        **/
+        enum struct context_type : uint8_t {
+            /**
+            * @brief Nothing continues from the previous line.
+            **/
+            none = 0,
+            /**
+            * @brief A quoted string continues from the previous line.
+            **/
+            string = 1,
+            /**
+            * @brief A quoteless string continues from the previous line after an escaped newline.
+            **/
+            quoteless_string = 2,
+            /**
+            * @brief A block comment continues from the previous line.
+            **/
+            block_comment = 3,
+        };
+
+        /**
+        * @brief The type of lexeme that continues from the previous line.
+        **/
+        context_type context = context_type::none;
+        /**
+        * @brief The quote character of the string.
+        **/
+        char quote_char = 0;
+        /**
+        * @brief Whether the string is verbatim (escape sequences are not processed).
+        **/
+        bool is_verbatim = false;
+        /**
+        * @brief The number of quotes that start the string, or the number of @c = that start the nestable block comment.
+        **/
+        uint32_t counter = 0;
+
+        bool operator==(const state&) const noexcept = default;
+    };
+
+    /**
+    * @brief The options to use when lexing JSONH (only @ref jsonh_reader_options::version applies).
+    **/
+    jsonh_reader_options options;
+
+    /**
+    * @brief Constructs a lexer that lexes JSONH lines.
+    **/
+    explicit jsonh_line_lexer(jsonh_reader_options options = jsonh_reader_options()) noexcept
+        : options(options) {
+    }
+
+    /**
+    * @brief Appends the lexemes of a single line to @c lexemes and returns the state at the start of the next line.
+    *
+    * A trailing newline in @c line is ignored. Whitespace is not included in the lexemes.
+    **/
+    state lex_line(std::string_view line, state start_state, std::vector<jsonh_lexeme>& lexemes) const noexcept {
+        // Exclude newline
+        while (!line.empty() && (line.back() == '\n' || line.back() == '\r')) {
+            line.remove_suffix(1);
+        }
+
+        size_t index = 0;
+        size_t first_lexeme_index = lexemes.size();
+        state current_state = start_state;
+
+        // Continue from previous line
+        switch (start_state.context) {
+            // Quoted string
+            case state::context_type::string: {
+                if (scan_quoted_string(line, index, current_state)) {
+                    current_state = state();
+                }
+                lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::string, 0, index }));
+                break;
+            }
+            // Quoteless string
+            case state::context_type::quoteless_string: {
+                current_state = state();
+                lex_quoteless_string(line, index, false, true, current_state, lexemes);
+                break;
+            }
+            // Block comment
+            case state::context_type::block_comment: {
+                if (scan_block_comment(line, index, current_state.counter)) {
+                    current_state = state();
+                }
+                lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::comment, 0, index }));
+                break;
+            }
+            // Nothing
+            default: {
+                break;
+            }
+        }
+
+        while (index < line.size() && current_state.context == state::context_type::none) {
+            size_t start_index = index;
+
+            switch (line[index]) {
+                // Whitespace
+                case ' ': case '\t': case '\v': case '\f': {
+                    index++;
+                    break;
+                }
+                // Structural characters
+                case '{': {
+                    index++;
+                    lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::start_object, start_index, 1 }));
+                    break;
+                }
+                case '}': {
+                    index++;
+                    lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::end_object, start_index, 1 }));
+                    break;
+                }
+                case '[': {
+                    index++;
+                    lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::start_array, start_index, 1 }));
+                    break;
+                }
+                case ']': {
+                    index++;
+                    lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::end_array, start_index, 1 }));
+                    break;
+                }
+                case ',': {
+                    index++;
+                    lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::comma, start_index, 1 }));
+                    break;
+                }
+                // Colon (previous value is a property name)
+                case ':': {
+                    index++;
+                    if (lexemes.size() > first_lexeme_index) {
+                        jsonh_lexeme& previous = lexemes.back();
+                        if (previous.type >= jsonh_lexeme_type::string && previous.type <= jsonh_lexeme_type::null) {
+                            previous.type = jsonh_lexeme_type::property_name;
+                        }
+                    }
+                    lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::colon, start_index, 1 }));
+                    break;
+                }
+                // Hash-style comment
+                case '#': {
+                    index = line.size();
+                    lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::comment, start_index, index - start_index }));
+                    break;
+                }
+                // Line-style or block-style comment
+                case '/': {
+                    lex_comment(line, index, current_state, lexemes);
+                    break;
+                }
+                // Quoted string
+                case '"': case '\'': {
+                    lex_quoted_string(line, index, start_index, false, current_state, lexemes);
+                    break;
+                }
+                // Verbatim string
+                case '@': {
+                    if (options.supports_version(jsonh_version::v2)) {
+                        index++;
+                        if (index < line.size() && (line[index] == '"' || line[index] == '\'')) {
+                            lex_quoted_string(line, index, start_index, true, current_state, lexemes);
+                        }
+                        else {
+                            lex_quoteless_string(line, index, true, false, current_state, lexemes, start_index);
+                        }
+                        break;
+                    }
+                    lex_quoteless_string(line, index, false, false, current_state, lexemes);
+                    break;
+                }
+                // Quoteless string, number or named literal
+                default: {
+                    lex_quoteless_string(line, index, false, false, current_state, lexemes);
+                    break;
+                }
+            }
+        }
+
+        return current_state;
+    }
+    /**
+    * @brief Lexes lines after an edit, starting from @c first_line, until the states reconverge after the edited lines.
+    *
+    * @c last_line is the index after the last edited line.
+    * @c line_states holds the state at the start of each line plus the state after the last line,
+    * and @c line_lexemes holds the lexemes of each line. Both are resized to match @c lines.
+    * Lines inserted or removed by the edit must already be inserted into or removed from both.
+    *
+    * Returns the index after the last line that was lexed.
+    **/
+    size_t relex(std::span<const std::string_view> lines, std::vector<state>& line_states, std::vector<std::vector<jsonh_lexeme>>& line_lexemes,
+        size_t first_line, size_t last_line) const noexcept {
+
+        line_states.resize(lines.size() + 1);
+        line_lexemes.resize(lines.size());
+
+        for (size_t line_index = first_line; line_index < lines.size(); line_index++) {
+            line_lexemes[line_index].clear();
+            state end_state = lex_line(lines[line_index], line_states[line_index], line_lexemes[line_index]);
+
+            // States reconverged
+            if (line_index + 1 >= last_line && line_states[line_index + 1] == end_state) {
+                return line_index + 1;
+            }
+            line_states[line_index + 1] = end_state;
+        }
+        return lines.size();
+    }
+
+private:
+    void lex_comment(std::string_view line, size_t& index, state& current_state, std::vector<jsonh_lexeme>& lexemes) const noexcept {
+        size_t start_index = index;
+        index++;
+
+        // Line-style comment
+        if (index < line.size() && line[index] == '/') {
+            index = line.size();
+            lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::comment, start_index, index - start_index }));
+            return;
+        }
+
+        // Count nests
+        uint32_t nest_counter = 0;
+        if (options.supports_version(jsonh_version::v2)) {
+            while (index < line.size() && line[index] == '=') {
+                index++;
+                nest_counter++;
+            }
+        }
+
+        // Block-style comment
+        if (index < line.size() && line[index] == '*') {
+            index++;
+            if (!scan_block_comment(line, index, nest_counter)) {
+                current_state.context = state::context_type::block_comment;
+                current_state.counter = nest_counter;
+            }
+            lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::comment, start_index, index - start_index }));
+            return;
+        }
+
+        // Invalid comment
+        lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::invalid, start_index, index - start_index }));
+    }
+    void lex_quoted_string(std::string_view line, size_t& index, size_t start_index, bool is_verbatim, state& current_state, std::vector<jsonh_lexeme>& lexemes) const noexcept {
+        char quote_char = line[index];
+
+        // Count multiple start quotes
+        uint32_t start_quote_counter = 0;
+        while (index < line.size() && line[index] == quote_char) {
+            index++;
+            start_quote_counter++;
+        }
+
+        // Non-empty string
+        if (start_quote_counter != 2) {
+            state string_state;
+            string_state.context = state::context_type::string;
+            string_state.quote_char = quote_char;
+            string_state.is_verbatim = is_verbatim;
+            string_state.counter = start_quote_counter;
+
+            if (!scan_quoted_string(line, index, string_state)) {
+                current_state = string_state;
+            }
+        }
+
+        lexemes.push_back(jsonh_lexeme({ jsonh_lexeme_type::string, start_index, index - start_index }));
+    }
+    void lex_quoteless_string(std::string_view line, size_t& index, bool is_verbatim, bool is_continuation, state& current_state,
+        std::vector<jsonh_lexeme>& lexemes, std::optional<size_t> start_index = std::nullopt) const noexcept {
+
+        if (!start_index) {
+            start_index = index;
+        }
+        // Get index after last non-whitespace char
+        size_t end_index = index;
+        bool has_escape_sequence = false;
+
+        while (index < line.size()) {
+            char next = line[index];
+
+            // Escape sequence
+            if (next == '\\') {
+                index++;
+                if (!is_verbatim) {
+                    has_escape_sequence = true;
+
+                    // Escaped newline
+                    if (index >= line.size()) {
+                        current_state.context = state::context_type::quoteless_string;
+                        end_index = index;
+                        break;
+                    }
+                    index++;
+                }
+                end_index = index;
+            }
+            // End on reserved character
+            else if (is_reserved_char(next)) {
+                break;
+            }
+            // Literal character
+            else {
+                index++;
+                if (!is_whitespace_char(next)) {
+                    end_index = index;
+                }
+            }
+        }
+
+        size_t length = end_index - start_index.value();
+        if (length == 0) {
+            return;
+        }
+
+        // Match named literal or number
+        jsonh_lexeme_type type = jsonh_lexeme_type::string;
+        if (!is_verbatim && !is_continuation && !has_escape_sequence) {
+            std::string_view text = line.substr(start_index.value(), length);
+            if (text == "null") {
+                type = jsonh_lexeme_type::null;
+            }
+            else if (text == "true") {
+                type = jsonh_lexeme_type::true_bool;
+            }
+            else if (text == "false") {
+                type = jsonh_lexeme_type::false_bool;
+            }
+            else if (is_number(text)) {
+                type = jsonh_lexeme_type::number;
+            }
+        }
+
+        lexemes.push_back(jsonh_lexeme({ type, start_index.value(), length }));
+    }
+    static bool scan_quoted_string(std::string_view line, size_t& index, const state& string_state) noexcept {
+        // Count multiple end quotes
+        uint32_t end_quote_counter = 0;
+
+        while (index < line.size()) {
+            char next = line[index];
+            index++;
+
+            // End quote
+            if (next == string_state.quote_char) {
+                end_quote_counter++;
+                if (end_quote_counter == string_state.counter) {
+                    return true;
+                }
+                continue;
+            }
+            end_quote_counter = 0;
+
+            // Escape sequence
+            if (next == '\\' && !string_state.is_verbatim && index < line.size()) {
+                index++;
+            }
+        }
+        return false;
+    }
+    bool scan_block_comment(std::string_view line, size_t& index, uint32_t start_nest_counter) const noexcept {
+        while (index < line.size()) {
+            char next = line[index];
+            index++;
+
+            // End of block comment
+            if (next == '*') {
+                // Count nests
+                size_t end_index = index;
+                uint32_t end_nest_counter = 0;
+                if (options.supports_version(jsonh_version::v2)) {
+                    while (end_nest_counter < start_nest_counter && end_index < line.size() && line[end_index] == '=') {
+                        end_index++;
+                        end_nest_counter++;
+                    }
+                }
+                // Partial end nestable block comment was actually part of comment
+                if (end_nest_counter < start_nest_counter) {
+                    continue;
+                }
+
+                if (end_index < line.size() && line[end_index] == '/') {
+                    index = end_index + 1;
+                    return true;
+                }
+            }
+        }
+        return false;
+    }
+    bool is_reserved_char(char next) const noexcept {
+        switch (next) {
+            case '\\': case ',': case ':': case '[': case ']': case '{': case '}': case '/': case '#': case '"': case '\'': {
+                return true;
+            }
+            case '@': {
+                return options.supports_version(jsonh_version::v2);
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+    static bool is_whitespace_char(char next) noexcept {
+        return next == ' ' || next == '\t' || next == '\v' || next == '\f';
+    }
+    static bool is_number(std::string_view text) noexcept {
+        size_t index = 0;
+
+        // Sign
+        if (index < text.size() && (text[index] == '-' || text[index] == '+')) {
+            index++;
+        }
+
+        // Base specifier
+        std::string_view base_digits = "0123456789";
+        if (text.size() - index >= 2 && text[index] == '0') {
+            switch (text[index + 1]) {
+                case 'x': case 'X': base_digits = "0123456789abcdefABCDEF"; index += 2; break;
+                case 'b': case 'B': base_digits = "01"; index += 2; break;
+                case 'o': case 'O': base_digits = "01234567"; index += 2; break;
+                default: break;
+            }
+        }
+
+        // Digits
+        size_t digits_start = index;
+        if (!scan_number_digits(text, index, base_digits)) {
+            return false;
+        }
+
+        // Hexadecimal exponent (`e` is a digit, so the sign is required)
+        if (base_digits.size() == 22) {
+            if ((text[index - 1] == 'e' || text[index - 1] == 'E') && index < text.size() && (text[index] == '-' || text[index] == '+')) {
+                // Missing digit between base specifier and exponent (e.g. `0xe+`)
+                if (index - digits_start == 1) {
+                    return false;
+                }
+                index++;
+                if (!scan_number_digits(text, index, base_digits)) {
+                    return false;
+                }
+            }
+        }
+        // Exponent
+        else if (index < text.size() && (text[index] == 'e' || text[index] == 'E')) {
+            index++;
+            if (index < text.size() && (text[index] == '-' || text[index] == '+')) {
+                index++;
+            }
+            if (!scan_number_digits(text, index, base_digits)) {
+                return false;
+            }
+        }
+
+        return index == text.size();
+    }
+    static bool scan_number_digits(std::string_view text, size_t& index, std::string_view base_digits) noexcept {
+        bool has_digit = false;
+        bool has_dot = false;
+
+        while (index < text.size()) {
+            char next = text[index];
+            if (base_digits.find(next) != std::string_view::npos) {
+                has_digit = true;
+            }
+            // Digit separator
+            else if (next == '_' && has_digit) {
+            }
+            else if (next == '.' && !has_dot) {
+                has_dot = true;
+            }
+            else {
+                break;
+            }
+            index++;
+        }
+        return has_digit;
+    }
+};
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+namespace jsonh_cpp {
+
+/**
+* @brief Methods for writing and reading the little-endian integers in index, checkpoint and cache files.
+**/
+class jsonh_little_endian final {
+public:
+    /**
+    * @brief Appends the lowest @c size bytes of the integer to @c bytes.
+    **/
+    static void write_integer(std::vector<std::uint8_t>& bytes, uint64_t value, size_t size = 8) noexcept {
+        for (size_t index = 0; index < size; index++) {
+            bytes.push_back((std::uint8_t)(value >> (index * 8)));
+        }
+    }
+    /**
+    * @brief Reads an integer of @c size bytes from @c bytes at @c offset, moving @c offset past it.
+    *
+    * Returns false if there are fewer than @c size bytes after @c offset.
+    **/
+    static bool read_integer(const std::vector<std::uint8_t>& bytes, size_t& offset, uint64_t& value, size_t size = 8) noexcept {
+        if (offset > bytes.size() || bytes.size() - offset < size) {
+            return false;
+        }
+        value = 0;
+        for (size_t index = 0; index < size; index++) {
+            value |= (uint64_t)bytes[offset + index] << (index * 8);
+        }
+        offset += size;
+        return true;
+    }
+};
+
+}
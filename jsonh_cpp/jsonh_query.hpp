@@ -0,0 +1,533 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <optional>
+#include <algorithm>
+#include <cstddef>
+#include "martinmoene/expected.hpp"
+#include "nlohmann/json.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief A compiled query that selects elements by path, evaluated as the elements are read or over a parsed element.
+*
+* @code{.unparsed}
+* .a.b          property
+* ."a b" or ["a b"]  quoted property
+* [0]           item
+* .* or [*]     every property or item
+* ..a or ..[*]  step at any depth (recursive descent)
+* [?(.a.b)]     every property or item that has the path
+* [?(.a >= 2)]  every property or item where the path compares to a JSON literal (==, !=, <, <=, >, >=)
+* {a, b}        projection of the selected objects (at the end of the query)
+* @endcode
+*
+* The query is a nondeterministic automaton whose states are indexes of the next step to match.
+**/
+struct jsonh_query {
+    /**
+    * @brief A condition on a property or item, used by @ref step_type::filter.
+    **/
+    struct predicate {
+        /**
+        * @brief The ways to compare the value at @ref path to @ref value.
+        **/
+        enum struct comparison_type : uint8_t {
+            exists = 0,
+            equal = 1,
+            not_equal = 2,
+            less = 3,
+            less_or_equal = 4,
+            greater = 5,
+            greater_or_equal = 6,
+        };
+
+        /**
+        * @brief The property names leading to the compared value.
+        **/
+        std::vector<std::string> path;
+        /**
+        * @brief How to compare the value at @ref path.
+        **/
+        comparison_type comparison = comparison_type::exists;
+        /**
+        * @brief The value to compare to.
+        **/
+        nlohmann::json value;
+
+        /**
+        * @brief Returns whether the element satisfies the predicate.
+        **/
+        bool test(const nlohmann::json& element) const noexcept {
+            // Find value at path
+            const nlohmann::json* current = &element;
+            for (const std::string& property_name : path) {
+                if (!current->is_object()) {
+                    return false;
+                }
+                nlohmann::json::const_iterator property = current->find(property_name);
+                if (property == current->end()) {
+                    return false;
+                }
+                current = &property.value();
+            }
+
+            switch (comparison) {
+                case comparison_type::exists: return true;
+                case comparison_type::equal: return *current == value;
+                case comparison_type::not_equal: return *current != value;
+                default: break;
+            }
+
+            // Order numbers and strings
+            int order = 0;
+            if (current->is_number() && value.is_number()) {
+                double left = current->get<double>();
+                double right = value.get<double>();
+                order = left < right ? -1 : (left > right ? 1 : 0);
+            }
+            else if (current->is_string() && value.is_string()) {
+                order = current->get_ref<const std::string&>().compare(value.get_ref<const std::string&>());
+            }
+            else {
+                return false;
+            }
+
+            switch (comparison) {
+                case comparison_type::less: return order < 0;
+                case comparison_type::less_or_equal: return order <= 0;
+                case comparison_type::greater: return order > 0;
+                default: return order >= 0;
+            }
+        }
+    };
+
+    /**
+    * @brief The types of steps in a query.
+    **/
+    enum struct step_type : uint8_t {
+        property = 0,
+        item = 1,
+        wildcard = 2,
+        filter = 3,
+    };
+
+    /**
+    * @brief A step from an element to some of its properties or items.
+    **/
+    struct step {
+        /**
+        * @brief The type of the step.
+        **/
+        step_type type = step_type::wildcard;
+        /**
+        * @brief The property name to match (for @ref step_type::property).
+        **/
+        std::string property_name;
+        /**
+        * @brief The item index to match (for @ref step_type::item).
+        **/
+        size_t item_index = 0;
+        /**
+        * @brief The condition the property or item must satisfy (for @ref step_type::filter).
+        **/
+        predicate condition;
+        /**
+        * @brief Whether the step also matches the descendants of the element.
+        **/
+        bool is_recursive = false;
+    };
+
+    /**
+    * @brief The steps of the query.
+    **/
+    std::vector<step> steps;
+    /**
+    * @brief The property names to keep in the selected objects, or none to keep the selected elements unchanged.
+    **/
+    std::optional<std::vector<std::string>> projection;
+
+    /**
+    * @brief Compiles a query from its text.
+    **/
+    static nonstd::expected<jsonh_query, std::string> compile(std::string_view text) noexcept {
+        jsonh_query query;
+        size_t index = 0;
+
+        // Optional root
+        if (text.substr(index, 1) == "." && text.substr(index, 2) != ".." && (text.size() == 1 || text[1] == '[' || text[1] == '{' || text[1] == ' ')) {
+            index++;
+        }
+
+        while (true) {
+            skip_whitespace(text, index);
+            if (index >= text.size()) {
+                break;
+            }
+
+            // Projection
+            if (text[index] == '{') {
+                nonstd::expected<void, std::string> projection_result = compile_projection(text, index, query);
+                if (!projection_result) {
+                    return nonstd::unexpected<std::string>(projection_result.error());
+                }
+                skip_whitespace(text, index);
+                if (index < text.size()) {
+                    return nonstd::unexpected<std::string>("Expected end of query after projection");
+                }
+                break;
+            }
+
+            // Recursive descent
+            bool is_recursive = false;
+            if (text.substr(index, 2) == "..") {
+                is_recursive = true;
+                index += 2;
+            }
+            else if (text[index] == '.') {
+                index++;
+            }
+            else if (text[index] != '[') {
+                return nonstd::unexpected<std::string>("Expected `.` or `[` in query");
+            }
+
+            // Step
+            nonstd::expected<step, std::string> next_step = compile_step(text, index);
+            if (!next_step) {
+                return nonstd::unexpected<std::string>(next_step.error());
+            }
+            next_step.value().is_recursive = is_recursive;
+            query.steps.push_back(std::move(next_step.value()));
+        }
+
+        return query;
+    }
+
+    /**
+    * @brief Returns the states at the root element.
+    **/
+    std::vector<size_t> start_states() const noexcept {
+        return { 0 };
+    }
+    /**
+    * @brief Returns whether an element with the given states is selected.
+    **/
+    bool is_match(const std::vector<size_t>& states) const noexcept {
+        return !states.empty() && states.back() == steps.size();
+    }
+    /**
+    * @brief Returns whether an element with the given states may have selected descendants.
+    **/
+    bool has_pending_states(const std::vector<size_t>& states) const noexcept {
+        return !states.empty() && states.front() < steps.size();
+    }
+    /**
+    * @brief Gets the states of a property or item from the states of its parent.
+    *
+    * Returns false if @c value is null and a filter step needs the value of the property or item.
+    **/
+    bool next_states(const std::vector<size_t>& states, const std::string* property_name, size_t item_index, const nlohmann::json* value,
+        std::vector<size_t>& child_states) const noexcept {
+
+        child_states.clear();
+        for (size_t state : states) {
+            if (state >= steps.size()) {
+                continue;
+            }
+            const step& current_step = steps[state];
+
+            // Keep searching descendants
+            if (current_step.is_recursive) {
+                child_states.push_back(state);
+            }
+
+            // Match step
+            bool is_step_match = false;
+            switch (current_step.type) {
+                case step_type::property: {
+                    is_step_match = property_name && *property_name == current_step.property_name;
+                    break;
+                }
+                case step_type::item: {
+                    is_step_match = !property_name && item_index == current_step.item_index;
+                    break;
+                }
+                case step_type::wildcard: {
+                    is_step_match = true;
+                    break;
+                }
+                case step_type::filter: {
+                    if (!value) {
+                        return false;
+                    }
+                    is_step_match = current_step.condition.test(*value);
+                    break;
+                }
+            }
+            if (is_step_match) {
+                child_states.push_back(state + 1);
+            }
+        }
+
+        // Sort and remove duplicates
+        std::sort(child_states.begin(), child_states.end());
+        child_states.erase(std::unique(child_states.begin(), child_states.end()), child_states.end());
+        return true;
+    }
+    /**
+    * @brief Appends the elements selected from a parsed element with the given states to @c results, in document order.
+    **/
+    void select(const nlohmann::json& element, const std::vector<size_t>& states, std::vector<nlohmann::json>& results) const noexcept {
+        // Selected element
+        if (is_match(states)) {
+            results.push_back(project(element));
+        }
+        if (!has_pending_states(states)) {
+            return;
+        }
+
+        // Properties and items
+        std::vector<size_t> child_states;
+        if (element.is_object()) {
+            for (const auto& [property_name, property_value] : element.items()) {
+                next_states(states, &property_name, 0, &property_value, child_states);
+                if (!child_states.empty()) {
+                    select(property_value, child_states, results);
+                }
+            }
+        }
+        else if (element.is_array()) {
+            for (size_t item_index = 0; item_index < element.size(); item_index++) {
+                next_states(states, nullptr, item_index, &element[item_index], child_states);
+                if (!child_states.empty()) {
+                    select(element[item_index], child_states, results);
+                }
+            }
+        }
+    }
+    /**
+    * @brief Returns the elements selected from a parsed element, in document order.
+    **/
+    std::vector<nlohmann::json> select(const nlohmann::json& element) const noexcept {
+        std::vector<nlohmann::json> results;
+        select(element, start_states(), results);
+        return results;
+    }
+    /**
+    * @brief Applies @ref projection to a selected element.
+    **/
+    nlohmann::json project(const nlohmann::json& element) const noexcept {
+        if (!projection || !element.is_object()) {
+            return element;
+        }
+        nlohmann::json projected = nlohmann::json::object();
+        for (const std::string& property_name : projection.value()) {
+            nlohmann::json::const_iterator property = element.find(property_name);
+            if (property != element.end()) {
+                projected[property_name] = property.value();
+            }
+        }
+        return projected;
+    }
+
+private:
+    static void skip_whitespace(std::string_view text, size_t& index) noexcept {
+        while (index < text.size() && (text[index] == ' ' || text[index] == '\t' || text[index] == '\n' || text[index] == '\r')) {
+            index++;
+        }
+    }
+    static nonstd::expected<std::string, std::string> compile_name(std::string_view text, size_t& index) noexcept {
+        // Quoted name
+        if (index < text.size() && text[index] == '"') {
+            size_t start_index = index;
+            index++;
+            while (index < text.size() && text[index] != '"') {
+                if (text[index] == '\\') {
+                    index++;
+                }
+                index++;
+            }
+            if (index >= text.size()) {
+                return nonstd::unexpected<std::string>("Expected end of quoted name in query");
+            }
+            index++;
+            nlohmann::json name = nlohmann::json::parse(text.substr(start_index, index - start_index), nullptr, false);
+            if (!name.is_string()) {
+                return nonstd::unexpected<std::string>("Invalid quoted name in query");
+            }
+            return name.get<std::string>();
+        }
+
+        // Identifier
+        size_t start_index = index;
+        while (index < text.size() && (std::isalnum((unsigned char)text[index]) || text[index] == '_' || text[index] == '$' || text[index] == '-' || (unsigned char)text[index] >= 0x80)) {
+            index++;
+        }
+        if (index == start_index) {
+            return nonstd::unexpected<std::string>("Expected name in query");
+        }
+        return std::string(text.substr(start_index, index - start_index));
+    }
+    static nonstd::expected<step, std::string> compile_step(std::string_view text, size_t& index) noexcept {
+        step next_step;
+
+        // Wildcard (.*)
+        if (index < text.size() && text[index] == '*') {
+            index++;
+            next_step.type = step_type::wildcard;
+            return next_step;
+        }
+        // Property (.name)
+        if (index >= text.size() || text[index] != '[') {
+            nonstd::expected<std::string, std::string> name = compile_name(text, index);
+            if (!name) {
+                return nonstd::unexpected<std::string>(name.error());
+            }
+            next_step.type = step_type::property;
+            next_step.property_name = std::move(name.value());
+            return next_step;
+        }
+
+        // Opening bracket
+        index++;
+        skip_whitespace(text, index);
+
+        // Wildcard ([*] or [])
+        if (index < text.size() && (text[index] == '*' || text[index] == ']')) {
+            if (text[index] == '*') {
+                index++;
+            }
+            next_step.type = step_type::wildcard;
+        }
+        // Filter ([?(predicate)])
+        else if (text.substr(index, 2) == "?(") {
+            index += 2;
+            nonstd::expected<predicate, std::string> condition = compile_predicate(text, index);
+            if (!condition) {
+                return nonstd::unexpected<std::string>(condition.error());
+            }
+            next_step.type = step_type::filter;
+            next_step.condition = std::move(condition.value());
+        }
+        // Quoted property (["name"])
+        else if (index < text.size() && text[index] == '"') {
+            nonstd::expected<std::string, std::string> name = compile_name(text, index);
+            if (!name) {
+                return nonstd::unexpected<std::string>(name.error());
+            }
+            next_step.type = step_type::property;
+            next_step.property_name = std::move(name.value());
+        }
+        // Item ([0])
+        else {
+            size_t start_index = index;
+            size_t item_index = 0;
+            while (index < text.size() && text[index] >= '0' && text[index] <= '9') {
+                item_index = (item_index * 10) + (text[index] - '0');
+                index++;
+            }
+            if (index == start_index) {
+                return nonstd::unexpected<std::string>("Expected item index in query");
+            }
+            next_step.type = step_type::item;
+            next_step.item_index = item_index;
+        }
+
+        // Closing bracket
+        skip_whitespace(text, index);
+        if (index >= text.size() || text[index] != ']') {
+            return nonstd::unexpected<std::string>("Expected `]` in query");
+        }
+        index++;
+        return next_step;
+    }
+    static nonstd::expected<predicate, std::string> compile_predicate(std::string_view text, size_t& index) noexcept {
+        predicate condition;
+
+        // Path
+        skip_whitespace(text, index);
+        while (index < text.size() && text[index] == '.') {
+            index++;
+            nonstd::expected<std::string, std::string> name = compile_name(text, index);
+            if (!name) {
+                return nonstd::unexpected<std::string>(name.error());
+            }
+            condition.path.push_back(std::move(name.value()));
+        }
+        if (condition.path.empty()) {
+            return nonstd::unexpected<std::string>("Expected path in query predicate");
+        }
+
+        // Comparison
+        skip_whitespace(text, index);
+        static constexpr std::pair<std::string_view, predicate::comparison_type> comparisons[] = {
+            { "==", predicate::comparison_type::equal }, { "!=", predicate::comparison_type::not_equal },
+            { "<=", predicate::comparison_type::less_or_equal }, { ">=", predicate::comparison_type::greater_or_equal },
+            { "<", predicate::comparison_type::less }, { ">", predicate::comparison_type::greater },
+        };
+        for (const std::pair<std::string_view, predicate::comparison_type>& comparison : comparisons) {
+            if (text.substr(index, comparison.first.size()) == comparison.first) {
+                index += comparison.first.size();
+                condition.comparison = comparison.second;
+
+                // Literal (up to closing parenthesis outside of string)
+                size_t start_index = index;
+                bool is_in_string = false;
+                while (index < text.size() && (is_in_string || text[index] != ')')) {
+                    if (text[index] == '\\' && is_in_string) {
+                        index++;
+                    }
+                    else if (text[index] == '"') {
+                        is_in_string = !is_in_string;
+                    }
+                    index++;
+                }
+                condition.value = nlohmann::json::parse(text.substr(start_index, std::min(index, text.size()) - start_index), nullptr, false);
+                if (condition.value.is_discarded() || condition.value.is_structured()) {
+                    return nonstd::unexpected<std::string>("Expected JSON literal in query predicate");
+                }
+                break;
+            }
+        }
+
+        // Closing parenthesis
+        skip_whitespace(text, index);
+        if (index >= text.size() || text[index] != ')') {
+            return nonstd::unexpected<std::string>("Expected `)` in query predicate");
+        }
+        index++;
+        return condition;
+    }
+    static nonstd::expected<void, std::string> compile_projection(std::string_view text, size_t& index, jsonh_query& query) noexcept {
+        // Opening brace
+        index++;
+        query.projection = std::vector<std::string>();
+
+        while (true) {
+            skip_whitespace(text, index);
+            nonstd::expected<std::string, std::string> name = compile_name(text, index);
+            if (!name) {
+                return nonstd::unexpected<std::string>(name.error());
+            }
+            query.projection.value().push_back(std::move(name.value()));
+
+            // Comma or closing brace
+            skip_whitespace(text, index);
+            if (index < text.size() && text[index] == ',') {
+                index++;
+            }
+            else if (index < text.size() && text[index] == '}') {
+                index++;
+                return nonstd::expected<void, std::string>(); // Success
+            }
+            else {
+                return nonstd::unexpected<std::string>("Expected `,` or `}` in query projection");
+            }
+        }
+    }
+};
+
+}
@@ -4,21 +4,38 @@
 #include <sstream>
 #include <vector>
 #include <set>
+#include <unordered_set>
 #include <stack>
 #include <optional>
 #include <algorithm>
 #include <ios>
 #include <istream>
+#include <ostream>
 #include <memory>
 #include <string_view>
+#include <array>
 #include <utility>
 #include <cstdint>
+#include <charconv>
+#include <limits>
+#include <cmath>
+#include <type_traits>
 #include "martinmoene/expected.hpp"
 #include "nlohmann/json.hpp"
 #include "jsonh_token.hpp"
+#include "jsonh_element_location.hpp"
+#include "jsonh_diagnostic.hpp"
+#include "jsonh_binary_format.hpp"
+#include "jsonh_binary_writer.hpp"
+#include "jsonh_index.hpp"
+#include "jsonh_checkpoint.hpp"
+#include "jsonh_query.hpp"
+#include "jsonh_extractor.hpp"
+#include "jsonh_semantic_hasher.hpp"
 #include "jsonh_reader_options.hpp"
 #include "jsonh_number_parser.hpp"
 #include "utf8_reader.hpp"
+#include "shared_string_stream.hpp"
 #include "jsonh_token_type.hpp"
 #include "jsonh_version.hpp"
 #include "lewissbaker/generator.hpp"
@@ -61,6 +78,14 @@ public:
     explicit jsonh_reader(const std::string& string, jsonh_reader_options options = jsonh_reader_options()) noexcept
         : jsonh_reader(std::make_unique<std::istringstream>(string), options) {
     }
+    /**
+    * @brief Constructs a reader that reads JSONH from a shared immutable UTF-8 string without copying it.
+    *
+    * Each reader has its own position, so multiple readers over the same string can be used concurrently (one per thread).
+    **/
+    explicit jsonh_reader(std::shared_ptr<const std::string> string, jsonh_reader_options options = jsonh_reader_options()) noexcept
+        : jsonh_reader(std::make_unique<shared_string_stream>(std::move(string)), options) {
+    }
 
     /**
     * @brief Parses a single element from a UTF-8 input stream and deserializes it as @ref T.
@@ -117,142 +142,153 @@ public:
     * @brief Parses a single element from the reader.
     **/
     nonstd::expected<json, std::string> parse_element() noexcept {
-        std::stack<json> current_elements;
-        std::optional<std::string> current_property_name;
+        return parse_element_with_locations(nullptr);
+    }
+    /**
+    * @brief Parses a single element from the reader and appends the location of each element to @c locations.
+    *
+    * The locations are in pre-order (the order the elements start in the input), so the root element is first.
+    **/
+    nonstd::expected<json, std::string> parse_element(std::vector<jsonh_element_location>& locations) noexcept {
+        return parse_element_with_locations(&locations);
+    }
+    /**
+    * @brief Parses a single element from the reader, recovering from errors and appending them to @c diagnostics.
+    *
+    * After an error in an object or array, the reader skips to the next `,`, newline or closing bracket at the same depth and continues,
+    * so the result contains every property and item that could be read. Missing closing brackets are also recovered from.
+    *
+    * An error is returned if it cannot be recovered from (such as an invalid root element) or once @ref jsonh_reader_options::max_diagnostics is reached.
+    **/
+    nonstd::expected<json, std::string> parse_element(std::vector<jsonh_diagnostic>& diagnostics) noexcept {
+        size_t start_index = diagnostics.size();
+
+        // Parse element recovering from errors
+        this->diagnostics = &diagnostics;
+        nonstd::expected<json, std::string> element = parse_element_with_locations(nullptr);
+        this->diagnostics = nullptr;
+
+        // Get line and column of each diagnostic
+        for (size_t index = start_index; index < diagnostics.size(); index++) {
+            std::pair<size_t, size_t> line_and_column = get_line_and_column(diagnostics[index].position);
+            diagnostics[index].line = line_and_column.first;
+            diagnostics[index].column = line_and_column.second;
+        }
+        return element;
+    }
+    /**
+    * @brief Parses each item of an array from the reader one at a time and deserializes it as @ref T.
+    **/
+    template <typename T>
+    std::generator<nonstd::expected<T, std::string>> parse_items() noexcept {
+        for (nonstd::expected<json, std::string>&& item : parse_items()) {
+            if (!item) {
+                co_yield(nonstd::unexpected<std::string>(item.error()));
+                co_return;
+            }
+            co_yield(item.value().template get<T>());
+        }
+    }
+    /**
+    * @brief Parses each item of an array from the reader one at a time.
+    *
+    * Only one item is held in memory at once, so arrays much larger than memory can be processed.
+    *
+    * A @ref checkpoint taken between items can be resumed to continue from the next item.
+    * If the generator is destroyed before the end of the array, the reader is left between items,
+    * so call @ref resume with a checkpoint before reading anything else.
+    **/
+    std::generator<nonstd::expected<json, std::string>> parse_items() noexcept {
+        nonstd::expected<void, std::string> skip_result;
 
-        auto submit_element = [&](const json& element) -> bool {
-            // Root value
-            if (current_elements.empty()) {
-                return true;
+        // Condition: skip opening bracket if resumed between items
+        if (!is_in_items) {
+            // Comments & whitespace
+            skip_result = skip_comments_and_whitespace();
+            if (!skip_result) {
+                co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+                co_return;
             }
-            // Array item
-            if (!current_property_name) {
-                current_elements.top().push_back(element);
-                return false;
+
+            // Opening bracket
+            if (!read_one("[")) {
+                co_yield(nonstd::unexpected<std::string>("Expected `[` to start array"));
+                co_return;
             }
-            // Object property
-            else {
-                current_elements.top()[current_property_name.value()] = element;
-                current_property_name.reset();
-                return false;
+            depth++;
+            is_in_items = true;
+            item_count = 0;
+
+            // Check exceeded max depth
+            if (depth > options.max_depth) {
+                is_in_items = false;
+                co_yield(nonstd::unexpected<std::string>("Exceeded max depth"));
+                co_return;
             }
-        };
-        auto start_element = [&](const json& element) -> void {
-            submit_element(element);
-            current_elements.push(element);
-        };
-        auto parse_next_element = [&]() -> nonstd::expected<json, std::string> {
-            for (const nonstd::expected<jsonh_token, std::string>& token_result : read_element()) {
-                // Check error
-                if (!token_result) {
-                    return nonstd::unexpected<std::string>(token_result.error());
-                }
-                jsonh_token token = token_result.value();
-
-                switch (token.json_type) {
-                    // Null
-                    case json_token_type::null: {
-                        json element = json(nullptr);
-                        if (submit_element(element)) {
-                            return element;
-                        }
-                        break;
-                    }
-                    // True
-                    case json_token_type::true_bool: {
-                        json element = json(true);
-                        if (submit_element(element)) {
-                            return element;
-                        }
-                        break;
-                    }
-                    // False
-                    case json_token_type::false_bool: {
-                        json element = json(false);
-                        if (submit_element(element)) {
-                            return element;
-                        }
-                        break;
-                    }
-                    // String
-                    case json_token_type::string: {
-                        json element = json(token.value);
-                        if (submit_element(element)) {
-                            return element;
-                        }
-                        break;
-                    }
-                    // Number
-                    case json_token_type::number: {
-                        nonstd::expected<long double, std::string> result = jsonh_number_parser::parse(token.value);
-                        if (!result) {
-                            return nonstd::unexpected<std::string>(result.error());
-                        }
-                        json element = json(result.value());
-                        if (submit_element(element)) {
-                            return element;
-                        }
-                        break;
-                    }
-                    // Start Object
-                    case json_token_type::start_object: {
-                        json element = json::object();
-                        start_element(element);
-                        break;
-                    }
-                    // Start Array
-                    case json_token_type::start_array: {
-                        json element = json::array();
-                        start_element(element);
-                        break;
-                    }
-                    // End Object/Array
-                    case json_token_type::end_object: case json_token_type::end_array: {
-                        // Nested element
-                        if (current_elements.size() > 1) {
-                            current_elements.pop();
-                        }
-                        // Root element
-                        else {
-                            return current_elements.top();
-                        }
-                        break;
-                    }
-                    // Property Name
-                    case json_token_type::property_name: {
-                        current_property_name = token.value;
-                        break;
-                    }
-                    // Comment
-                    case json_token_type::comment: {
-                        break;
-                    }
-                    // Not implemented
-                    default: {
-                        return nonstd::unexpected<std::string>("Token type not implemented");
-                    }
+        }
+
+        while (true) {
+            // Comments & whitespace
+            skip_result = skip_comments_and_whitespace();
+            if (!skip_result) {
+                is_in_items = false;
+                co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+                co_return;
+            }
+
+            // Optional comma after previous item
+            if (item_count > 0 && read_one(",")) {
+                // Comments & whitespace
+                skip_result = skip_comments_and_whitespace();
+                if (!skip_result) {
+                    is_in_items = false;
+                    co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+                    co_return;
                 }
             }
 
-            // End of input
-            return nonstd::unexpected<std::string>("Expected token, got end of input");
-        };
+            std::optional<std::string> next = peek();
+            if (!next) {
+                // End of incomplete array
+                if (options.incomplete_inputs) {
+                    depth--;
+                    is_in_items = false;
+                    break;
+                }
+                // Missing closing bracket
+                is_in_items = false;
+                co_yield(nonstd::unexpected<std::string>("Expected `]` to end array, got end of input"));
+                co_return;
+            }
 
-        // Parse next element
-        nonstd::expected<json, std::string> next_element = parse_next_element();
+            // Closing bracket
+            if (next.value() == "]") {
+                read();
+                depth--;
+                is_in_items = false;
+                break;
+            }
+
+            // Item
+            nonstd::expected<json, std::string> item = parse_next_element();
+            if (!item) {
+                is_in_items = false;
+                co_yield(std::move(item));
+                co_return;
+            }
+            item_count++;
+            co_yield(std::move(item));
+        }
 
         // Ensure exactly one element
-        if (next_element) {
-            if (options.parse_single_element) {
-                for (const nonstd::expected<jsonh_token, std::string>& token : read_end_of_elements()) {
-                    if (!token) {
-                        return nonstd::unexpected<std::string>(token.error());
-                    }
+        if (options.parse_single_element) {
+            for (const nonstd::expected<jsonh_token, std::string>& token : read_end_of_elements()) {
+                if (!token) {
+                    co_yield(nonstd::unexpected<std::string>(token.error()));
+                    co_return;
                 }
             }
         }
-
-        return next_element;
     }
     /**
      * @brief Parses a single element as minified JSON from the reader.
@@ -348,271 +384,3290 @@ public:
                 }
                 // String
                 case json_token_type::string: {
-                    result_builder.append(json(token.value).dump());
-                    if (current_depth == 0) {
-                        return result_builder;
-                    }
+                    result_builder.append(json(token.value).dump());
+                    if (current_depth == 0) {
+                        return result_builder;
+                    }
+                    break;
+                }
+                // Number
+                case json_token_type::number: {
+                    nonstd::expected<long double, std::string> result = jsonh_number_parser::parse(token.value);
+                    if (!result) {
+                        return nonstd::unexpected<std::string>(result.error());
+                    }
+                    result_builder.append(json(result.value()).dump());
+                    if (current_depth == 0) {
+                        return result_builder;
+                    }
+                    break;
+                }
+                // Start Object
+                case json_token_type::start_object: {
+                    result_builder.push_back('{');
+                    current_depth++;
+                    break;
+                }
+                // Start Array
+                case json_token_type::start_array: {
+                    result_builder.push_back('[');
+                    current_depth++;
+                    break;
+                }
+                // End Object
+                case json_token_type::end_object: {
+                    result_builder.push_back('}');
+                    current_depth--;
+                    if (current_depth == 0) {
+                        return result_builder;
+                    }
+                    break;
+                }
+                // End Array
+                case json_token_type::end_array: {
+                    result_builder.push_back(']');
+                    current_depth--;
+                    if (current_depth == 0) {
+                        return result_builder;
+                    }
+                    break;
+                }
+                // Property Name
+                case json_token_type::property_name: {
+                    result_builder.append(json(token.value).dump());
+                    result_builder.push_back(':');
+                    if (indent) {
+                        result_builder.push_back(' ');
+                    }
+                    break;
+                }
+                // Comment
+                case json_token_type::comment: {
+                    if (include_comments) {
+                        result_builder.append("/*");
+                        std::string comment_value = token.value;
+                        replace_all(comment_value, "/*", "/ *");
+                        replace_all(comment_value, "*/", "* /");
+                        result_builder.append(comment_value);
+                        result_builder.append("*/");
+                    }
+                    break;
+                }
+                // Not implemented
+                default: {
+                    return nonstd::unexpected<std::string>("Token type not implemented");
+                }
+            }
+
+            is_property_value = token.json_type == json_token_type::property_name;
+        }
+
+        // End of input
+        return nonstd::unexpected<std::string>("Expected token, got end of input");
+    }
+    /**
+    * @brief Parses a single element as canonical JSON (RFC 8785) from the reader and writes it to the output.
+    *
+    * Properties are sorted by the UTF-16 code units of their names, numbers are formatted like ECMAScript and strings are minimally escaped.
+    * Only objects are buffered (to sort their properties), so memory is bounded by the largest object rather than the whole element.
+    **/
+    nonstd::expected<void, std::string> parse_canonical_json(std::ostream& output) noexcept {
+        skip_comments_scope skip_comments(*this);
+        nonstd::expected<void, std::string> result = write_next_canonical_element(output);
+        if (!result) {
+            return result;
+        }
+
+        // Ensure exactly one element
+        if (options.parse_single_element) {
+            for (const nonstd::expected<jsonh_token, std::string>& token : read_end_of_elements()) {
+                if (!token) {
+                    return nonstd::unexpected<std::string>(token.error());
+                }
+            }
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    /**
+    * @brief Parses a single element as canonical JSON (RFC 8785) from the reader.
+    **/
+    nonstd::expected<std::string, std::string> parse_canonical_json() noexcept {
+        std::ostringstream output;
+        nonstd::expected<void, std::string> result = parse_canonical_json(output);
+        if (!result) {
+            return nonstd::unexpected<std::string>(result.error());
+        }
+        return output.str();
+    }
+    /**
+    * @brief Parses a single element from the reader and transcodes it to the given binary format in a single pass, writing it to @c output.
+    *
+    * No element is built. CBOR and UBJSON are written as they are read, so memory is only used for the current nesting of objects and arrays.
+    * MessagePack and BSON lengths are filled in at the end of each structure, so the root element is buffered until it ends.
+    **/
+    nonstd::expected<void, std::string> parse_binary(jsonh_binary_format format, std::ostream& output) noexcept {
+        jsonh_binary_writer writer(format, output);
+
+        skip_comments_scope skip_comments(*this);
+        nonstd::expected<void, std::string> result = transcode_next_element(writer);
+        if (!result) {
+            return result;
+        }
+
+        // Ensure exactly one element
+        if (options.parse_single_element) {
+            for (const nonstd::expected<jsonh_token, std::string>& token : read_end_of_elements()) {
+                if (!token) {
+                    return nonstd::unexpected<std::string>(token.error());
+                }
+            }
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    /**
+    * @brief Parses a single element from the reader and transcodes it to the given binary format in a single pass.
+    **/
+    nonstd::expected<std::vector<std::uint8_t>, std::string> parse_binary(jsonh_binary_format format) noexcept {
+        std::ostringstream output;
+        nonstd::expected<void, std::string> result = parse_binary(format, output);
+        if (!result) {
+            return nonstd::unexpected<std::string>(result.error());
+        }
+        std::string bytes = output.str();
+        return std::vector<std::uint8_t>(bytes.begin(), bytes.end());
+    }
+    /**
+    * @brief Parses a single element from the reader, passing each event to a nlohmann/json SAX handler (such as @c json::json_sax_t).
+    *
+    * Numbers without a fraction or exponent are passed as integers if they fit in 64 bits. Other numbers are passed as floats.
+    *
+    * Returns @c false if the element is invalid or the handler stopped parsing.
+    **/
+    template <typename SAX>
+    bool sax_parse(SAX* sax) {
+        skip_comments_scope skip_comments(*this);
+        if (!sax_parse_next_element(sax)) {
+            return false;
+        }
+
+        // Ensure exactly one element
+        if (options.parse_single_element) {
+            for (const nonstd::expected<jsonh_token, std::string>& token : read_end_of_elements()) {
+                if (!token) {
+                    return sax->parse_error(position(), "", json::parse_error::create(101, position(), token.error(), nullptr));
+                }
+            }
+        }
+        return true;
+    }
+    /**
+    * @brief Tries to find the given property name in the reader.
+    * 
+    * For example, to find @c c:
+    * 
+    * @code{.jsonh}
+    * // Original position
+    * {
+    *   "a": "1",
+    *   "b": {
+    *     "c": "2"
+    *   },
+    *   "c": // Final position
+    *        "3"
+    * }
+    * @endcode
+    **/
+    bool find_property_value(const std::string& property_name) noexcept {
+        int64_t current_depth = 0;
+
+        for (const nonstd::expected<jsonh_token, std::string>& token_result : read_element()) {
+            // Check error
+            if (!token_result) {
+                return false;
+            }
+
+            switch (token_result.value().json_type) {
+                // Start structure
+                case json_token_type::start_object: case json_token_type::start_array: {
+                    current_depth++;
+                    break;
+                }
+                // End structure
+                case json_token_type::end_object: case json_token_type::end_array: {
+                    current_depth--;
+                    break;
+                }
+                // Property name
+                case json_token_type::property_name: {
+                    if (current_depth == 1 && token_result.value().value == property_name) {
+                        // Path found
+                        return true;
+                    }
+                    break;
+                }
+                // Other
+                default: {
+                    break;
+                }
+            }
+        }
+
+        // Path not found
+        return false;
+    }
+    /**
+    * @brief Parses an array of numbers from the reader directly into a vector of @ref T, without creating a @c json for each item.
+    *
+    * Errors if an item is not a number, or (for integral types) is not an integer in the range of @ref T.
+    **/
+    template <typename T> requires (std::is_arithmetic_v<T> && !std::is_same_v<T, bool>)
+    nonstd::expected<std::vector<T>, std::string> parse_number_array() noexcept {
+        skip_comments_scope skip_comments(*this);
+        return parse_next_number_array<T>();
+    }
+    /**
+    * @brief Reads the next element and yields the elements selected by the query, in document order.
+    *
+    * Properties and items that cannot contain selected elements are skipped without being parsed.
+    * Only selected elements and the properties and items tested by a filter are parsed.
+    *
+    * Duplicate properties in the objects read follow @ref jsonh_duplicate_property_policy (duplicates in skipped properties and items are not detected).
+    * With @ref jsonh_duplicate_property_policy::last_wins, the results in each object are yielded when the object ends, since a later duplicate property can replace them.
+    * With @ref jsonh_duplicate_property_policy::collect, the element is parsed before selecting.
+    **/
+    std::generator<nonstd::expected<json, std::string>> select(jsonh_query query) noexcept {
+        // Collected values need the whole element
+        if (options.duplicate_property_policy == jsonh_duplicate_property_policy::collect) {
+            nonstd::expected<json, std::string> element = parse_next_element();
+            if (!element) {
+                co_yield(nonstd::unexpected<std::string>(element.error()));
+                co_return;
+            }
+            for (json& result : query.select(element.value())) {
+                co_yield(std::move(result));
+            }
+            co_return;
+        }
+
+        for (nonstd::expected<json, std::string>&& result : select_next_element(query, query.start_states(), false)) {
+            if (!result) {
+                co_yield(std::move(result));
+                co_return;
+            }
+            co_yield(std::move(result));
+        }
+    }
+    /**
+    * @brief Reads the next element and counts the elements selected by the query.
+    *
+    * Unlike @ref select, selected elements are skipped without being parsed unless they may contain other selected elements.
+    **/
+    nonstd::expected<size_t, std::string> count(const jsonh_query& query) noexcept {
+        // Collected values need the whole element
+        if (options.duplicate_property_policy == jsonh_duplicate_property_policy::collect) {
+            nonstd::expected<json, std::string> element = parse_next_element();
+            if (!element) {
+                return nonstd::unexpected<std::string>(element.error());
+            }
+            return query.select(element.value()).size();
+        }
+
+        size_t match_count = 0;
+        for (const nonstd::expected<json, std::string>& result : select_next_element(query, query.start_states(), true)) {
+            if (!result) {
+                return nonstd::unexpected<std::string>(result.error());
+            }
+            match_count++;
+        }
+        return match_count;
+    }
+    /**
+    * @brief Reads the next element and extracts the paths of the extractor into the slots in a single pass, returning the number of slots filled.
+    *
+    * Slots whose path is not found are @c std::nullopt. Properties and items not on any path are skipped without being parsed.
+    * Once every slot is filled, the rest of each array (and each object with @ref jsonh_duplicate_property_policy::first_wins) is skipped without being parsed.
+    * The reader always ends after the element, so the next element can be extracted from the same reader.
+    *
+    * The slots are the same as @c extractor.run on the parsed element with the same @ref jsonh_duplicate_property_policy.
+    * With @ref jsonh_duplicate_property_policy::error and @ref jsonh_duplicate_property_policy::collect, the element is parsed before extracting.
+    **/
+    nonstd::expected<size_t, std::string> extract(const jsonh_extractor& extractor, std::vector<std::optional<json>>& slots) noexcept {
+        slots.assign(extractor.slot_count, std::nullopt);
+        size_t remaining_count = extractor.slot_count;
+
+        // Duplicate property errors and collected values need the whole element
+        if (options.duplicate_property_policy == jsonh_duplicate_property_policy::error || options.duplicate_property_policy == jsonh_duplicate_property_policy::collect) {
+            nonstd::expected<json, std::string> element = parse_next_element();
+            if (!element) {
+                return nonstd::unexpected<std::string>(element.error());
+            }
+            return extractor.run(element.value(), slots);
+        }
+
+        nonstd::expected<void, std::string> extract_result = extract_next_element(extractor, 0, slots, remaining_count);
+        if (!extract_result) {
+            return nonstd::unexpected<std::string>(extract_result.error());
+        }
+        return extractor.slot_count - remaining_count;
+    }
+    /**
+    * @brief Reads the next element from both readers and returns whether they are equal.
+    *
+    * The elements are compared while they are read, so quoting, number bases, comments and whitespace are ignored.
+    * Objects are only parsed from the first property whose name differs (e.g. if the properties are in a different order),
+    * or entirely if a property name is repeated so that the duplicate property policy is applied before comparing.
+    * The rest of an array is skipped at the first difference.
+    **/
+    static nonstd::expected<bool, std::string> equals(jsonh_reader& left, jsonh_reader& right) noexcept {
+        return left.diff_next_element(right, json::json_pointer(), nullptr);
+    }
+    /**
+    * @brief Reads the next element from both readers and returns a JSON Patch (RFC 6902) that transforms the left element into the right element.
+    *
+    * The elements are compared while they are read, so quoting, number bases, comments and whitespace are ignored.
+    * Objects are only parsed from the first property whose name differs (e.g. if the properties are in a different order),
+    * or entirely if a property name is repeated so that the duplicate property policy is applied before comparing.
+    * The patch is empty if the elements are equal.
+    **/
+    static nonstd::expected<json, std::string> diff(jsonh_reader& left, jsonh_reader& right) noexcept {
+        json patch = json::array();
+        nonstd::expected<bool, std::string> diff_result = left.diff_next_element(right, json::json_pointer(), &patch);
+        if (!diff_result) {
+            return nonstd::unexpected<std::string>(diff_result.error());
+        }
+        return patch;
+    }
+    /**
+    * @brief Reads the next element and returns its semantic hash (see @ref jsonh_semantic_hasher) without parsing it.
+    *
+    * The hash equals @c jsonh_semantic_hasher::hash of the parsed element, so comments, whitespace, quoting, number bases and property order do not change it.
+    **/
+    nonstd::expected<uint64_t, std::string> semantic_hash() noexcept {
+        skip_comments_scope skip_comments(*this);
+        return hash_next_element();
+    }
+    /**
+    * @brief Returns the state of the reader, which can be passed to @ref resume to continue reading the same input later.
+    *
+    * Checkpoints can only be taken between elements or between the items yielded by @ref parse_items.
+    **/
+    jsonh_checkpoint checkpoint() const noexcept {
+        return jsonh_checkpoint({ position(), depth, is_in_items, item_count });
+    }
+    /**
+    * @brief Restores the state of the reader from a checkpoint taken by @ref checkpoint for the same input.
+    *
+    * Returns whether the input contains the checkpoint position.
+    **/
+    bool resume(const jsonh_checkpoint& checkpoint) noexcept {
+        seek(checkpoint.position);
+        if (position() != checkpoint.position) {
+            return false;
+        }
+        depth = checkpoint.depth;
+        is_in_items = checkpoint.is_in_items;
+        item_count = checkpoint.item_count;
+        return true;
+    }
+    /**
+    * @brief Reads a single element from the reader and indexes the positions of its properties and every @c item_interval items.
+    *
+    * The index can be saved and used to seek to a property (@ref seek_property) or item (@ref seek_item) in the same input later.
+    **/
+    nonstd::expected<jsonh_index, std::string> build_index(size_t item_interval = 1024) noexcept {
+        skip_comments_scope skip_comments(*this);
+        return build_next_index(item_interval);
+    }
+    /**
+    * @brief Seeks to the value of the given property of the root object using an index built by @ref build_index.
+    *
+    * If there are multiple properties with the name, seeks to the last one (as in @ref parse_element).
+    * Returns whether the property was found. The next element read is the property value.
+    *
+    * Returns false if the index was built from a different input (see @ref jsonh_index::input_hash). The first seek hashes the whole input to check this.
+    **/
+    bool seek_property(const jsonh_index& index, const std::string& property_name) noexcept {
+        if (!is_index_of_input(index)) {
+            return false;
+        }
+
+        // Binary search for last property with name
+        std::vector<jsonh_index::property>::const_iterator next_property = std::upper_bound(index.properties.begin(), index.properties.end(), property_name,
+            [](const std::string& name, const jsonh_index::property& property) { return name < property.name; });
+        if (next_property == index.properties.begin() || std::prev(next_property)->name != property_name) {
+            return false;
+        }
+
+        // Seek to property value
+        seek(std::prev(next_property)->position);
+        depth = 1;
+        return true;
+    }
+    /**
+    * @brief Seeks to the item at the given index of the root array using an index built by @ref build_index.
+    *
+    * Seeks to the nearest indexed item before it and reads the items in between.
+    * Returns whether the item was found. The next element read is the item.
+    *
+    * Returns false if the index was built from a different input (see @ref jsonh_index::input_hash). The first seek hashes the whole input to check this.
+    **/
+    bool seek_item(const jsonh_index& index, size_t item_index) noexcept {
+        if (!index.is_array || item_index >= index.item_count || item_index / index.item_interval >= index.item_positions.size()) {
+            return false;
+        }
+        if (!is_index_of_input(index)) {
+            return false;
+        }
+
+        // Seek to nearest indexed item
+        seek(index.item_positions[item_index / index.item_interval]);
+        depth = 1;
+
+        // Skip items in between
+        skip_comments_scope skip_comments(*this);
+        for (size_t skip_count = item_index % index.item_interval; skip_count > 0; skip_count--) {
+            if (!skip_item()) {
+                return false;
+            }
+        }
+        return true;
+    }
+    /**
+    * @brief Parses the items from @c start_index up to (but not including) @c end_index of an array from the reader.
+    *
+    * The preceding items are skipped without being parsed, and the reader stops after the last item in the range.
+    * If the array has fewer items, the returned array is shorter.
+    **/
+    nonstd::expected<json, std::string> parse_range(size_t start_index, size_t end_index) noexcept {
+        skip_comments_scope skip_comments(*this);
+        return parse_next_range(start_index, end_index);
+    }
+    /**
+    * @brief Parses the items from @c start_index up to (but not including) @c end_index of the root array using an index built by @ref build_index.
+    *
+    * Seeks to the nearest indexed item before the range, so only the items in between are skipped.
+    **/
+    nonstd::expected<json, std::string> parse_range(const jsonh_index& index, size_t start_index, size_t end_index) noexcept {
+        if (!index.is_array) {
+            return nonstd::unexpected<std::string>("Expected array");
+        }
+        end_index = std::min(end_index, index.item_count);
+        if (start_index >= end_index) {
+            return json::array();
+        }
+        if (!seek_item(index, start_index)) {
+            return nonstd::unexpected<std::string>("Failed to seek to item");
+        }
+
+        skip_comments_scope skip_comments(*this);
+        return parse_next_items(0, end_index - start_index);
+    }
+    /**
+    * @brief Gets the line number and column number of the given byte position, both starting at 1.
+    *
+    * The column number counts runes rather than bytes. @c \r\n is counted as a single newline.
+    *
+    * Newlines are indexed as they are first requested, so finding the locations of increasing positions is cheap.
+    **/
+    std::pair<size_t, size_t> get_line_and_column(size_t target_position) noexcept {
+        size_t original_position = position();
+
+        // Index newlines up to position
+        if (target_position > line_index_position) {
+            seek(line_index_position);
+            while (line_index_position < target_position) {
+                int next_byte = inner_stream->get();
+                if (next_byte < 0) {
+                    break;
+                }
+                line_index_position++;
+
+                // Line feed
+                if (next_byte == '\n') {
+                    line_start_positions.push_back(line_index_position);
+                }
+                // Carriage return (join CR LF)
+                else if (next_byte == '\r') {
+                    if (inner_stream->peek() == '\n') {
+                        inner_stream->get();
+                        line_index_position++;
+                    }
+                    line_start_positions.push_back(line_index_position);
+                }
+                // Line separator / paragraph separator
+                else if (next_byte == 0xE2) {
+                    int second_byte = inner_stream->get();
+                    int third_byte = inner_stream->get();
+                    if (second_byte < 0 || third_byte < 0) {
+                        break;
+                    }
+                    line_index_position += 2;
+                    if (second_byte == 0x80 && (third_byte == 0xA8 || third_byte == 0xA9)) {
+                        line_start_positions.push_back(line_index_position);
+                    }
+                }
+            }
+        }
+
+        // Find line
+        size_t line_index = std::upper_bound(line_start_positions.begin(), line_start_positions.end(), target_position) - line_start_positions.begin() - 1;
+        size_t line_start_position = line_start_positions[line_index];
+
+        // Count runes from start of line (or from last result on the same line)
+        size_t column_position = line_start_position;
+        size_t column = 1;
+        if (last_column_position >= line_start_position && last_column_position <= target_position) {
+            column_position = last_column_position;
+            column = last_column;
+        }
+        seek(column_position);
+        for (; column_position < target_position; column_position++) {
+            int next_byte = inner_stream->get();
+            if (next_byte < 0) {
+                break;
+            }
+            if (is_utf8_first_byte((uint8_t)next_byte)) {
+                column++;
+            }
+        }
+        last_column_position = column_position;
+        last_column = column;
+
+        seek(original_position);
+        return { line_index + 1, column };
+    }
+    /**
+    * @brief Reads whitespace and returns whether the reader contains another token.
+    **/
+    bool has_token() noexcept {
+        // Whitespace
+        read_whitespace();
+
+        // Peek char
+        return !!peek();
+    }
+    /**
+    * @brief Reads comments and whitespace and errors if the reader contains another element.
+    **/
+    std::generator<nonstd::expected<jsonh_token, std::string>> read_end_of_elements() noexcept {
+        // Comments & whitespace
+        for (nonstd::expected<jsonh_token, std::string>&& token : read_comments_and_whitespace()) {
+            if (!token) {
+                co_yield(std::move(token));
+                co_return;
+            }
+            co_yield(std::move(token));
+        }
+
+        // Peek char
+        if (!!peek()) {
+            co_yield(nonstd::unexpected<std::string>("Expected end of elements"));
+            co_return;
+        }
+    }
+    /**
+    * @brief Reads a single element from the reader.
+    **/
+    std::generator<nonstd::expected<jsonh_token, std::string>> read_element() noexcept {
+        // Comments & whitespace
+        for (nonstd::expected<jsonh_token, std::string>&& token : read_comments_and_whitespace()) {
+            if (!token) {
+                co_yield(std::move(token));
+                co_return;
+            }
+            co_yield(std::move(token));
+        }
+
+        // Peek rune
+        std::optional<std::string> next = peek();
+        if (!next) {
+            co_yield(nonstd::unexpected<std::string>("Expected token, got end of input"));
+            co_return;
+        }
+
+        // Object
+        if (next.value() == "{") {
+            for (nonstd::expected<jsonh_token, std::string>&& token : read_object()) {
+                if (!token) {
+                    co_yield(std::move(token));
+                    co_return;
+                }
+                co_yield(std::move(token));
+            }
+        }
+        // Array
+        else if (next.value() == "[") {
+            for (nonstd::expected<jsonh_token, std::string>&& token : read_array()) {
+                if (!token) {
+                    co_yield(std::move(token));
+                    co_return;
+                }
+                co_yield(std::move(token));
+            }
+        }
+        // Primitive value (null, true, false, string, number)
+        else {
+            nonstd::expected<jsonh_token, std::string> token = read_primitive_element();
+            if (!token) {
+                co_yield(nonstd::unexpected<std::string>(token.error()));
+                co_return;
+            }
+
+            // Detect braceless object from property name
+            for (nonstd::expected<jsonh_token, std::string>&& token2 : read_braceless_object_or_end_of_primitive(token.value())) {
+                if (!token2) {
+                    co_yield(std::move(token2));
+                    co_return;
+                }
+                co_yield(std::move(token2));
+            }
+        }
+    }
+
+private:
+    /**
+    * @brief The byte positions of the start of each line found by @ref get_line_and_column.
+    **/
+    std::vector<size_t> line_start_positions = { 0 };
+    /**
+    * @brief The byte position up to which newlines have been indexed by @ref get_line_and_column.
+    **/
+    size_t line_index_position = 0;
+    /**
+    * @brief The byte position and column of the last result of @ref get_line_and_column.
+    **/
+    size_t last_column_position = 0;
+    size_t last_column = 1;
+    /**
+    * @brief The size and hash of the whole input, computed once by @ref hash_input.
+    **/
+    std::optional<std::pair<size_t, uint64_t>> input_size_and_hash;
+    /**
+    * @brief Whether the reader is between the items of an array read by @ref parse_items.
+    **/
+    bool is_in_items = false;
+    /**
+    * @brief The number of items read by @ref parse_items in the current array.
+    **/
+    size_t item_count = 0;
+    /**
+    * @brief A set of property names that uses a linear search for small objects and a hash set for large objects.
+    **/
+    struct property_name_set {
+        std::vector<std::string> small_names;
+        std::unordered_set<std::string> large_names;
+        bool is_large = false;
+
+        /**
+        * @brief Removes all names, keeping the allocated storage for the next object.
+        **/
+        void clear() noexcept {
+            small_names.clear();
+            if (is_large) {
+                large_names.clear();
+                is_large = false;
+            }
+        }
+        /**
+        * @brief Adds the name and returns whether it was not already in the set.
+        **/
+        bool insert(const std::string& name) noexcept {
+            if (!is_large) {
+                // Linear search
+                if (std::find(small_names.begin(), small_names.end(), name) != small_names.end()) {
+                    return false;
+                }
+                if (small_names.size() < 16) {
+                    small_names.push_back(name);
+                    return true;
+                }
+                // Switch to hash set
+                large_names.insert(small_names.begin(), small_names.end());
+                is_large = true;
+            }
+            return large_names.insert(name).second;
+        }
+    };
+    /**
+    * @brief The property names read in each object being read, indexed by depth (only used with @ref jsonh_duplicate_property_policy::error).
+    **/
+    std::vector<property_name_set> property_name_sets;
+    /**
+    * @brief The state of an object being read by @ref start_next_structure and @ref read_next_property_name.
+    **/
+    struct object_walk {
+        /**
+        * @brief Whether the object is a braceless root object.
+        **/
+        bool is_braceless = false;
+        /**
+        * @brief The first property name of a braceless object, read by @ref start_next_structure to detect it.
+        **/
+        std::optional<std::string> braceless_property_name;
+        /**
+        * @brief The byte position of the first property and the depth inside the object, used by @ref restart_next_properties.
+        **/
+        size_t start_position = 0;
+        int32_t depth = 0;
+        /**
+        * @brief The property names read so far.
+        **/
+        property_name_set property_names;
+        /**
+        * @brief Whether the last property name read is a duplicate, and whether any has been read.
+        *
+        * Only duplicates with @ref jsonh_duplicate_property_policy::last_wins or @ref jsonh_duplicate_property_policy::collect are returned.
+        **/
+        bool is_duplicate = false;
+        bool has_duplicates = false;
+    };
+    /**
+    * @brief The diagnostics to add recovered errors to, or null if not recovering from errors.
+    **/
+    std::vector<jsonh_diagnostic>* diagnostics = nullptr;
+    /**
+    * @brief Whether comments are currently being skipped regardless of @ref jsonh_reader_options::skip_comments.
+    **/
+    bool is_skipping_comments = false;
+    /**
+    * @brief Skips comments (see @ref is_skipping_comments) until destroyed, for reads whose result does not include comments.
+    **/
+    struct skip_comments_scope {
+        jsonh_reader& reader;
+        bool original_is_skipping_comments;
+
+        explicit skip_comments_scope(jsonh_reader& reader) noexcept
+            : reader(reader), original_is_skipping_comments(reader.is_skipping_comments) {
+            reader.is_skipping_comments = true;
+        }
+        ~skip_comments_scope() noexcept {
+            reader.is_skipping_comments = original_is_skipping_comments;
+        }
+        skip_comments_scope(const skip_comments_scope&) = delete;
+        skip_comments_scope& operator=(const skip_comments_scope&) = delete;
+    };
+
+    /**
+    * @brief The integer values of hexadecimal digit bytes, or -1 for other bytes.
+    **/
+    static constexpr std::array<int8_t, 256> hex_digit_values = []() {
+        std::array<int8_t, 256> values = {};
+        values.fill(-1);
+        for (int8_t digit = 0; digit < 10; digit++) {
+            values['0' + digit] = digit;
+        }
+        for (int8_t digit = 0; digit < 6; digit++) {
+            values['a' + digit] = 10 + digit;
+            values['A' + digit] = 10 + digit;
+        }
+        return values;
+    }();
+    /**
+    * @brief Runes that cannot be used unescaped in quoteless strings.
+    **/
+    const std::set<std::string>& reserved_runes() { return options.supports_version(jsonh_version::v2) ? reserved_runes_v2 : reserved_runes_v1; }
+    /**
+    * @brief Runes that cannot be used unescaped in quoteless strings in JSONH V1.
+    **/
+    const std::set<std::string> reserved_runes_v1 = { "\\", ",", ":", "[", "]", "{", "}", "/", "#", "\"", "'" };
+    /**
+    * @brief Runes that cannot be used unescaped in quoteless strings in JSONH V2.
+    **/
+    const std::set<std::string> reserved_runes_v2 = { "\\", ",", ":", "[", "]", "{", "}", "/", "#", "\"", "'", "@" };
+    /**
+    * @brief Runes that are considered newlines.
+    **/
+    const std::set<std::string> newline_runes = { "\n", "\r", "\u2028", "\u2029" };
+    /**
+    * @brief Runes that are considered whitespace.
+    **/
+    const std::set<std::string> whitespace_runes = {
+        "\u0020", "\u00A0", "\u1680", "\u2000", "\u2001", "\u2002", "\u2003", "\u2004", "\u2005",
+        "\u2006", "\u2007", "\u2008", "\u2009", "\u200A", "\u202F", "\u205F", "\u3000", "\u2028",
+        "\u2029", "\u0009", "\u000A", "\u000B", "\u000C", "\u000D", "\u0085",
+    };
+
+    nonstd::expected<json, std::string> parse_element_with_locations(std::vector<jsonh_element_location>* locations) noexcept {
+        // Parse next element
+        nonstd::expected<json, std::string> next_element = parse_next_element(locations);
+
+        // Ensure exactly one element
+        if (next_element) {
+            if (options.parse_single_element) {
+                for (const nonstd::expected<jsonh_token, std::string>& token : read_end_of_elements()) {
+                    if (!token) {
+                        // Recover from extra element
+                        if (add_diagnostic(token.error())) {
+                            break;
+                        }
+                        return nonstd::unexpected<std::string>(token.error());
+                    }
+                }
+            }
+        }
+
+        return next_element;
+    }
+    nonstd::expected<json, std::string> parse_next_element(std::vector<jsonh_element_location>* locations = nullptr) noexcept {
+        skip_comments_scope skip_comments(*this);
+        return build_next_element(locations);
+    }
+    nonstd::expected<json, std::string> build_next_element(std::vector<jsonh_element_location>* locations) noexcept {
+        // JSON performance optimisation
+        if (!locations) {
+            std::optional<json> json_element = read_json_element();
+            if (json_element) {
+                return std::move(json_element.value());
+            }
+        }
+
+        std::stack<json> current_elements;
+        std::stack<std::optional<std::string>> current_element_property_names;
+        std::stack<std::set<std::string>> current_element_collected_property_names;
+        std::stack<size_t> current_element_location_indexes;
+        std::optional<std::string> current_property_name;
+
+        auto add_location = [&](const jsonh_token& token) -> void {
+            jsonh_element_location location;
+            // Get pointer from parent
+            if (!current_elements.empty()) {
+                const json::json_pointer& parent_pointer = (*locations)[current_element_location_indexes.top()].pointer;
+                location.pointer = current_property_name
+                    ? parent_pointer / current_property_name.value()
+                    : parent_pointer / current_elements.top().size();
+            }
+            // Get position
+            location.position = token.position;
+            location.length = token.length;
+            std::pair<size_t, size_t> line_and_column = get_line_and_column(token.position);
+            location.line = line_and_column.first;
+            location.column = line_and_column.second;
+            locations->push_back(std::move(location));
+        };
+        auto submit_element = [&](json&& element, std::optional<std::string>&& property_name) -> void {
+            // Array item
+            if (!property_name) {
+                current_elements.top().push_back(std::move(element));
+            }
+            // Object property (move name into key)
+            else {
+                json::object_t& object = current_elements.top().get_ref<json::object_t&>();
+                switch (options.duplicate_property_policy) {
+                    // Keep first value
+                    case jsonh_duplicate_property_policy::first_wins: {
+                        object.try_emplace(std::move(property_name.value()), std::move(element));
+                        break;
+                    }
+                    // Collect values into array
+                    case jsonh_duplicate_property_policy::collect: {
+                        std::pair<json::object_t::iterator, bool> result = object.try_emplace(property_name.value(), std::move(element));
+                        if (!result.second) {
+                            if (current_element_collected_property_names.top().insert(property_name.value()).second) {
+                                result.first->second = json::array({ std::move(result.first->second) });
+                            }
+                            result.first->second.push_back(std::move(element));
+                        }
+                        break;
+                    }
+                    // Replace value (duplicates are already errors with jsonh_duplicate_property_policy::error)
+                    default: {
+                        object.insert_or_assign(std::move(property_name.value()), std::move(element));
+                        break;
+                    }
+                }
+            }
+        };
+        auto submit_primitive_element = [&](const jsonh_token& token, json&& element) -> bool {
+            if (locations) {
+                add_location(token);
+            }
+            // Root value
+            if (current_elements.empty()) {
+                return true;
+            }
+            submit_element(std::move(element), std::move(current_property_name));
+            current_property_name.reset();
+            return false;
+        };
+        auto start_element = [&](const jsonh_token& token, json&& element) -> void {
+            if (locations) {
+                add_location(token);
+                current_element_location_indexes.push(locations->size() - 1);
+            }
+            current_elements.push(std::move(element));
+            current_element_property_names.push(std::move(current_property_name));
+            current_element_collected_property_names.push({});
+            current_property_name.reset();
+        };
+        auto end_element = [&](const jsonh_token& token) -> std::optional<json> {
+            if (locations) {
+                jsonh_element_location& location = (*locations)[current_element_location_indexes.top()];
+                location.length = token.position + token.length - location.position;
+                current_element_location_indexes.pop();
+            }
+            json element = std::move(current_elements.top());
+            current_elements.pop();
+            std::optional<std::string> property_name = std::move(current_element_property_names.top());
+            current_element_property_names.pop();
+            current_element_collected_property_names.pop();
+
+            // Root element
+            if (current_elements.empty()) {
+                return element;
+            }
+            // Nested element
+            submit_element(std::move(element), std::move(property_name));
+            return std::nullopt;
+        };
+
+        for (nonstd::expected<jsonh_token, std::string>&& token_result : read_element()) {
+            // Check error
+            if (!token_result) {
+                return nonstd::unexpected<std::string>(token_result.error());
+            }
+            jsonh_token& token = token_result.value();
+
+            switch (token.json_type) {
+                // Null
+                case json_token_type::null: {
+                    json element = json(nullptr);
+                    if (submit_primitive_element(token, std::move(element))) {
+                        return element;
+                    }
+                    break;
+                }
+                // True
+                case json_token_type::true_bool: {
+                    json element = json(true);
+                    if (submit_primitive_element(token, std::move(element))) {
+                        return element;
+                    }
+                    break;
+                }
+                // False
+                case json_token_type::false_bool: {
+                    json element = json(false);
+                    if (submit_primitive_element(token, std::move(element))) {
+                        return element;
+                    }
+                    break;
+                }
+                // String
+                case json_token_type::string: {
+                    json element = json(std::move(token.value));
+                    if (submit_primitive_element(token, std::move(element))) {
+                        return element;
+                    }
+                    break;
+                }
+                // Number
+                case json_token_type::number: {
+                    nonstd::expected<long double, std::string> result = jsonh_number_parser::parse(token.value);
+                    if (!result) {
+                        return nonstd::unexpected<std::string>(result.error());
+                    }
+                    json element = json(result.value());
+                    if (submit_primitive_element(token, std::move(element))) {
+                        return element;
+                    }
+                    break;
+                }
+                // Start Object
+                case json_token_type::start_object: {
+                    start_element(token, json::object());
+                    break;
+                }
+                // Start Array
+                case json_token_type::start_array: {
+                    start_element(token, json::array());
+                    break;
+                }
+                // End Object/Array
+                case json_token_type::end_object: case json_token_type::end_array: {
+                    // Property name without value (after recovering from an error)
+                    current_property_name.reset();
+
+                    std::optional<json> element = end_element(token);
+                    if (element) {
+                        return std::move(element.value());
+                    }
+                    break;
+                }
+                // Property Name
+                case json_token_type::property_name: {
+                    current_property_name = std::move(token.value);
+                    break;
+                }
+                // Comment
+                case json_token_type::comment: {
+                    break;
+                }
+                // Not implemented
+                default: {
+                    return nonstd::unexpected<std::string>("Token type not implemented");
+                }
+            }
+        }
+
+        // End of input
+        return nonstd::unexpected<std::string>("Expected token, got end of input");
+    }
+    template <typename T>
+    nonstd::expected<std::vector<T>, std::string> parse_next_number_array() noexcept {
+        // Comments & whitespace
+        nonstd::expected<void, std::string> skip_result = skip_comments_and_whitespace();
+        if (!skip_result) {
+            return nonstd::unexpected<std::string>(skip_result.error());
+        }
+
+        // Opening bracket
+        if (!read_one("[")) {
+            return nonstd::unexpected<std::string>("Expected `[` to start array");
+        }
+        depth++;
+
+        // Check exceeded max depth
+        if (depth > options.max_depth) {
+            return nonstd::unexpected<std::string>("Exceeded max depth");
+        }
+
+        std::vector<T> numbers;
+
+        while (true) {
+            // Comments & whitespace
+            skip_result = skip_comments_and_whitespace();
+            if (!skip_result) {
+                return nonstd::unexpected<std::string>(skip_result.error());
+            }
+
+            std::optional<std::string> next = peek();
+            if (!next) {
+                // End of incomplete array
+                if (options.incomplete_inputs) {
+                    depth--;
+                    break;
+                }
+                // Missing closing bracket
+                return nonstd::unexpected<std::string>("Expected `]` to end array, got end of input");
+            }
+
+            // Closing bracket
+            if (next.value() == "]") {
+                read();
+                depth--;
+                break;
+            }
+
+            // JSON number performance optimisation
+            size_t start_position = position();
+            std::string number_builder;
+            T number = {};
+            if (read_json_number(number_builder) && read_end_of_json_number() && parse_json_number(number_builder, number)) {
+                numbers.push_back(number);
+            }
+            // JSONH number
+            else {
+                seek(start_position);
+                nonstd::expected<jsonh_token, std::string> token = read_primitive_element();
+                if (!token) {
+                    return nonstd::unexpected<std::string>(token.error());
+                }
+                if (token.value().json_type != json_token_type::number) {
+                    return nonstd::unexpected<std::string>("Expected number in number array");
+                }
+                nonstd::expected<long double, std::string> result = jsonh_number_parser::parse(token.value().value);
+                if (!result) {
+                    return nonstd::unexpected<std::string>(result.error());
+                }
+                nonstd::expected<T, std::string> converted_result = convert_number<T>(result.value());
+                if (!converted_result) {
+                    return nonstd::unexpected<std::string>(converted_result.error());
+                }
+                numbers.push_back(converted_result.value());
+            }
+
+            // Comments & whitespace
+            skip_result = skip_comments_and_whitespace();
+            if (!skip_result) {
+                return nonstd::unexpected<std::string>(skip_result.error());
+            }
+
+            // Optional comma
+            read_one(",");
+        }
+
+        // Ensure exactly one element
+        if (options.parse_single_element) {
+            for (const nonstd::expected<jsonh_token, std::string>& token : read_end_of_elements()) {
+                if (!token) {
+                    return nonstd::unexpected<std::string>(token.error());
+                }
+            }
+        }
+
+        return numbers;
+    }
+    template <typename T>
+    static bool parse_json_number(std::string_view json_number, T& number) noexcept {
+        // Integers and floats in range (otherwise fall back to long double)
+        std::from_chars_result result = std::from_chars(json_number.data(), json_number.data() + json_number.size(), number);
+        return result.ec == std::errc() && result.ptr == json_number.data() + json_number.size();
+    }
+    template <typename T>
+    static nonstd::expected<T, std::string> convert_number(long double number) noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            // Ensure integer
+            if (number != std::trunc(number)) {
+                return nonstd::unexpected<std::string>("Expected integer in number array");
+            }
+            // Ensure in range (powers of 2 are exact)
+            long double upper_bound = std::ldexp(1.0L, std::numeric_limits<T>::digits);
+            long double lower_bound = std::is_signed_v<T> ? -upper_bound : 0.0L;
+            if (number < lower_bound || number >= upper_bound) {
+                return nonstd::unexpected<std::string>("Number out of range in number array");
+            }
+        }
+        return (T)number;
+    }
+    std::optional<json> read_json_element() noexcept {
+        // Whitespace
+        read_whitespace();
+
+        // Only objects and arrays (primitives may start braceless objects)
+        int next = inner_stream->rdbuf()->sgetc();
+        if (next != '{' && next != '[') {
+            return std::nullopt;
+        }
+
+        // Read strict JSON element
+        size_t start_position = position();
+        json element;
+        if (read_json_value(element, depth + 1)) {
+            inner_stream->clear();
+            return element;
+        }
+
+        // Fall back to JSONH element
+        seek(start_position);
+        return std::nullopt;
+    }
+    bool read_json_value(json& element, int32_t value_depth) noexcept {
+        std::streambuf* buffer = inner_stream->rdbuf();
+
+        auto skip_json_whitespace = [&]() -> void {
+            int next = buffer->sgetc();
+            while (next == ' ' || next == '\t' || next == '\n' || next == '\r') {
+                buffer->sbumpc();
+                next = buffer->sgetc();
+            }
+        };
+        auto read_json_string = [&](std::string& string_builder) -> bool {
+            buffer->sbumpc();
+            // Empty or multi-quoted string
+            if (buffer->sgetc() == '"') {
+                buffer->sbumpc();
+                return buffer->sgetc() != '"';
+            }
+            return !!read_single_quoted_string('"', false, string_builder);
+        };
+        auto read_json_literal = [&](std::string_view literal) -> bool {
+            for (char literal_char : literal) {
+                if (buffer->sbumpc() != literal_char) {
+                    return false;
+                }
+            }
+            return true;
+        };
+
+        switch (buffer->sgetc()) {
+            // Object
+            case '{': {
+                if (value_depth > options.max_depth) {
+                    return false;
+                }
+                buffer->sbumpc();
+                element = json::object();
+
+                skip_json_whitespace();
+                if (buffer->sgetc() == '}') {
+                    buffer->sbumpc();
+                    return true;
+                }
+                while (true) {
+                    // Property name
+                    skip_json_whitespace();
+                    std::string property_name;
+                    if (buffer->sgetc() != '"' || !read_json_string(property_name)) {
+                        return false;
+                    }
+                    skip_json_whitespace();
+                    if (buffer->sbumpc() != ':') {
+                        return false;
+                    }
+
+                    // Property value
+                    skip_json_whitespace();
+                    json property_value;
+                    if (!read_json_value(property_value, value_depth + 1)) {
+                        return false;
+                    }
+                    json::object_t& object = element.get_ref<json::object_t&>();
+                    if (options.duplicate_property_policy == jsonh_duplicate_property_policy::last_wins) {
+                        object.insert_or_assign(std::move(property_name), std::move(property_value));
+                    }
+                    // Keep first value or fall back to report error or collect values
+                    else if (!object.try_emplace(std::move(property_name), std::move(property_value)).second
+                        && options.duplicate_property_policy != jsonh_duplicate_property_policy::first_wins) {
+                        return false;
+                    }
+
+                    // Comma or closing brace
+                    skip_json_whitespace();
+                    int next = buffer->sbumpc();
+                    if (next == '}') {
+                        return true;
+                    }
+                    if (next != ',') {
+                        return false;
+                    }
+                }
+            }
+            // Array
+            case '[': {
+                if (value_depth > options.max_depth) {
+                    return false;
+                }
+                buffer->sbumpc();
+                element = json::array();
+
+                skip_json_whitespace();
+                if (buffer->sgetc() == ']') {
+                    buffer->sbumpc();
+                    return true;
+                }
+                while (true) {
+                    // Item
+                    skip_json_whitespace();
+                    json item;
+                    if (!read_json_value(item, value_depth + 1)) {
+                        return false;
+                    }
+                    element.push_back(std::move(item));
+
+                    // Comma or closing bracket
+                    skip_json_whitespace();
+                    int next = buffer->sbumpc();
+                    if (next == ']') {
+                        return true;
+                    }
+                    if (next != ',') {
+                        return false;
+                    }
+                }
+            }
+            // String
+            case '"': {
+                std::string string_builder;
+                if (!read_json_string(string_builder)) {
+                    return false;
+                }
+                element = json(std::move(string_builder));
+                return true;
+            }
+            // Named literals
+            case 't': {
+                element = json(true);
+                return read_json_literal("true");
+            }
+            case 'f': {
+                element = json(false);
+                return read_json_literal("false");
+            }
+            case 'n': {
+                element = json(nullptr);
+                return read_json_literal("null");
+            }
+            // Number
+            default: {
+                std::string number_builder;
+                if (!read_json_number(number_builder)) {
+                    return false;
+                }
+                nonstd::expected<long double, std::string> number = jsonh_number_parser::parse(number_builder);
+                if (!number) {
+                    return false;
+                }
+                element = json(number.value());
+                return true;
+            }
+        }
+    }
+    nonstd::expected<jsonh_index, std::string> build_next_index(size_t item_interval) noexcept {
+        if (item_interval == 0) {
+            return nonstd::unexpected<std::string>("Item interval must be greater than 0");
+        }
+
+        jsonh_index index;
+        index.item_interval = item_interval;
+        int64_t current_depth = 0;
+        bool is_property_value = false;
+
+        for (const nonstd::expected<jsonh_token, std::string>& token_result : read_element()) {
+            // Check error
+            if (!token_result) {
+                return nonstd::unexpected<std::string>(token_result.error());
+            }
+            const jsonh_token& token = token_result.value();
+
+            // Property of root object
+            if (current_depth == 1 && token.json_type == json_token_type::property_name) {
+                index.properties.push_back(jsonh_index::property({ token.value, 0 }));
+                is_property_value = true;
+                continue;
+            }
+            // Start of value in root structure
+            if (current_depth == 1 && token.json_type != json_token_type::end_object && token.json_type != json_token_type::end_array && token.json_type != json_token_type::comment) {
+                // Property value
+                if (is_property_value) {
+                    index.properties.back().position = token.position;
+                    is_property_value = false;
+                }
+                // Item
+                else {
+                    if (index.item_count % item_interval == 0) {
+                        index.item_positions.push_back(token.position);
+                    }
+                    index.item_count++;
+                }
+            }
+
+            switch (token.json_type) {
+                // Start structure
+                case json_token_type::start_object: case json_token_type::start_array: {
+                    if (current_depth == 0) {
+                        index.is_array = token.json_type == json_token_type::start_array;
+                    }
+                    current_depth++;
+                    break;
+                }
+                // End structure
+                case json_token_type::end_object: case json_token_type::end_array: {
+                    current_depth--;
+                    break;
+                }
+                // Other
+                default: {
+                    break;
+                }
+            }
+        }
+
+        // Sort properties for binary search
+        std::stable_sort(index.properties.begin(), index.properties.end(),
+            [](const jsonh_index::property& a, const jsonh_index::property& b) { return a.name < b.name; });
+
+        // Input size and hash
+        std::optional<std::pair<size_t, uint64_t>> input_size_and_hash = hash_input();
+        if (!input_size_and_hash) {
+            return nonstd::unexpected<std::string>("Failed to read input");
+        }
+        index.input_size = input_size_and_hash.value().first;
+        index.input_hash = input_size_and_hash.value().second;
+        return index;
+    }
+    std::optional<std::pair<size_t, uint64_t>> hash_input() noexcept {
+        // Input is only hashed once
+        if (input_size_and_hash) {
+            return input_size_and_hash;
+        }
+        size_t original_position = position();
+
+        // Read whole input in chunks
+        seek(0);
+        if (position() != 0) {
+            seek(original_position);
+            return std::nullopt;
+        }
+        std::array<char, 65536> chunk;
+        size_t input_size = 0;
+        uint64_t input_hash = jsonh_semantic_hasher::bytes_offset_basis;
+        while (true) {
+            size_t chunk_size = (size_t)inner_stream->rdbuf()->sgetn(chunk.data(), (std::streamsize)chunk.size());
+            input_hash = jsonh_semantic_hasher::hash_bytes(std::string_view(chunk.data(), chunk_size), input_hash);
+            input_size += chunk_size;
+            if (chunk_size < chunk.size()) {
+                break;
+            }
+        }
+
+        seek(original_position);
+        input_size_and_hash = std::pair<size_t, uint64_t>(input_size, input_hash);
+        return input_size_and_hash;
+    }
+    bool is_index_of_input(const jsonh_index& index) noexcept {
+        std::optional<std::pair<size_t, uint64_t>> input_size_and_hash = hash_input();
+        return input_size_and_hash && input_size_and_hash.value().first == index.input_size && input_size_and_hash.value().second == index.input_hash;
+    }
+    nonstd::expected<json, std::string> parse_next_range(size_t start_index, size_t end_index) noexcept {
+        // Comments
+        for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+            if (!token) {
+                return nonstd::unexpected<std::string>(token.error());
+            }
+        }
+
+        // Opening bracket
+        if (!read_one("[")) {
+            return nonstd::unexpected<std::string>("Expected `[` to start array");
+        }
+        depth++;
+
+        // Check exceeded max depth
+        if (depth > options.max_depth) {
+            return nonstd::unexpected<std::string>("Exceeded max depth");
+        }
+
+        return parse_next_items(start_index, end_index > start_index ? end_index - start_index : 0);
+    }
+    nonstd::expected<json, std::string> parse_next_items(size_t skip_count, size_t item_count) noexcept {
+        json items = json::array();
+
+        for (size_t item_index = 0; items.size() < item_count; item_index++) {
+            // Comments & whitespace
+            for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+                if (!token) {
+                    return nonstd::unexpected<std::string>(token.error());
+                }
+            }
+
+            std::optional<std::string> next = peek();
+            if (!next) {
+                // End of incomplete array
+                if (options.incomplete_inputs) {
+                    break;
+                }
+                // Missing closing bracket
+                return nonstd::unexpected<std::string>("Expected `]` to end array, got end of input");
+            }
+
+            // Closing bracket
+            if (next.value() == "]") {
+                break;
+            }
+            // Skip item
+            else if (item_index < skip_count) {
+                nonstd::expected<void, std::string> skip_result = skip_item();
+                if (!skip_result) {
+                    return nonstd::unexpected<std::string>(skip_result.error());
+                }
+            }
+            // Parse item
+            else {
+                nonstd::expected<json, std::string> item = build_next_element(nullptr);
+                if (!item) {
+                    return item;
+                }
+                items.push_back(std::move(item.value()));
+
+                // Comments & whitespace
+                for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+                    if (!token) {
+                        return nonstd::unexpected<std::string>(token.error());
+                    }
+                }
+
+                // Optional comma
+                read_one(",");
+            }
+        }
+
+        return items;
+    }
+    void start_property_names() noexcept {
+        if (options.duplicate_property_policy != jsonh_duplicate_property_policy::error) {
+            return;
+        }
+        // Reuse set for depth
+        if (property_name_sets.size() < (size_t)depth) {
+            property_name_sets.resize(depth);
+        }
+        property_name_sets[depth - 1].clear();
+    }
+    bool add_property_name(const std::string& property_name) noexcept {
+        if (options.duplicate_property_policy != jsonh_duplicate_property_policy::error) {
+            return true;
+        }
+        return property_name_sets[depth - 1].insert(property_name);
+    }
+    bool add_diagnostic(const std::string& error) noexcept {
+        // Not recovering or too many diagnostics
+        if (!diagnostics || diagnostics->size() >= options.max_diagnostics) {
+            return false;
+        }
+        diagnostics->push_back(jsonh_diagnostic({ error, position() }));
+        return true;
+    }
+    bool recover_from_error(const std::string& error, int32_t original_depth, char end_char) noexcept {
+        // Unclosed nested structure (such as exceeded max depth)
+        if (depth != original_depth) {
+            return false;
+        }
+        if (!add_diagnostic(error)) {
+            return false;
+        }
+        skip_to_next_property_or_item(end_char);
+        return true;
+    }
+    void skip_to_next_property_or_item(char end_char) noexcept {
+        // Scan bytes directly since all structural characters are ASCII
+        std::streambuf* buffer = inner_stream->rdbuf();
+        const int end_of_buffer = std::char_traits<char>::eof();
+
+        int32_t nest_counter = 0;
+        bool is_verbatim = false;
+
+        while (true) {
+            // Read byte
+            int next = buffer->sbumpc();
+            if (next == end_of_buffer) {
+                return;
+            }
+
+            switch (next) {
+                // Start of structure
+                case '{': case '[': {
+                    is_verbatim = false;
+                    nest_counter++;
+                    break;
+                }
+                // End of structure
+                case '}': case ']': {
+                    is_verbatim = false;
+                    if (nest_counter > 0) {
+                        nest_counter--;
+                    }
+                    // End of current structure (unmatched brackets are skipped)
+                    else if (next == end_char) {
+                        buffer->sungetc();
+                        return;
+                    }
+                    break;
+                }
+                // Comma
+                case ',': {
+                    is_verbatim = false;
+                    if (nest_counter == 0) {
+                        return;
+                    }
+                    break;
+                }
+                // Newline
+                case '\n': case '\r': {
+                    is_verbatim = false;
+                    if (nest_counter == 0) {
+                        if (next == '\r' && buffer->sgetc() == '\n') {
+                            buffer->sbumpc();
+                        }
+                        return;
+                    }
+                    break;
+                }
+                // Quoted string
+                case '"': case '\'': {
+                    if (!skip_quoted_string((char)next, is_verbatim)) {
+                        return;
+                    }
+                    is_verbatim = false;
+                    break;
+                }
+                // Comment
+                case '#': case '/': {
+                    buffer->sungetc();
+                    // Invalid comments are skipped like other invalid characters
+                    if (!skip_comment() && buffer->sgetc() == end_of_buffer) {
+                        return;
+                    }
+                    is_verbatim = false;
+                    break;
+                }
+                // Escape sequence (quoteless string)
+                case '\\': {
+                    if (!is_verbatim) {
+                        buffer->sbumpc();
+                    }
+                    break;
+                }
+                // Verbatim string
+                case '@': {
+                    is_verbatim = options.supports_version(jsonh_version::v2);
+                    break;
+                }
+                // End of verbatim quoteless string
+                case ':': {
+                    is_verbatim = false;
+                    break;
+                }
+                // Newline (\u2028, \u2029)
+                case 0xE2: {
+                    if (buffer->sgetc() == 0x80) {
+                        buffer->sbumpc();
+                        if (buffer->sgetc() == 0xA8 || buffer->sgetc() == 0xA9) {
+                            buffer->sbumpc();
+                            is_verbatim = false;
+                            if (nest_counter == 0) {
+                                return;
+                            }
+                        }
+                    }
+                    break;
+                }
+                // Other
+                default: {
+                    break;
+                }
+            }
+        }
+    }
+    nonstd::expected<void, std::string> skip_comments_and_whitespace() noexcept {
+        // Whitespace
+        read_whitespace();
+
+        // No comment performance optimisation
+        int next = inner_stream->rdbuf()->sgetc();
+        if (next != '#' && next != '/') {
+            return nonstd::expected<void, std::string>(); // Success
+        }
+
+        // Comments
+        skip_comments_scope skip_comments(*this);
+        nonstd::expected<void, std::string> result = nonstd::expected<void, std::string>();
+        for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+            if (!token) {
+                result = nonstd::unexpected<std::string>(token.error());
+            }
+        }
+        return result;
+    }
+    nonstd::expected<void, std::string> skip_item() noexcept {
+        // Element
+        nonstd::expected<void, std::string> skip_result = skip_element();
+        if (!skip_result) {
+            return skip_result;
+        }
+
+        // Comments & whitespace
+        for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+            if (!token) {
+                return nonstd::unexpected<std::string>(token.error());
+            }
+        }
+
+        // Optional comma
+        read_one(",");
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    nonstd::expected<void, std::string> skip_element() noexcept {
+        // Comments & whitespace
+        for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+            if (!token) {
+                return nonstd::unexpected<std::string>(token.error());
+            }
+        }
+
+        // Peek rune
+        std::optional<std::string> next = peek();
+        if (!next) {
+            return nonstd::unexpected<std::string>("Expected token, got end of input");
+        }
+
+        // Object or array
+        if (next.value() == "{" || next.value() == "[") {
+            return skip_structure();
+        }
+        // Primitive value
+        nonstd::expected<jsonh_token, std::string> token = read_primitive_element();
+        if (!token) {
+            return nonstd::unexpected<std::string>(token.error());
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    nonstd::expected<void, std::string> skip_structure(int32_t nest_counter = 0) noexcept {
+        // Scan bytes directly since all structural characters are ASCII (nest_counter is the number of structures already started)
+        std::streambuf* buffer = inner_stream->rdbuf();
+        const int end_of_buffer = std::char_traits<char>::eof();
+
+        bool is_verbatim = false;
+
+        while (true) {
+            // Read byte
+            int next = buffer->sbumpc();
+            if (next == end_of_buffer) {
+                // End of incomplete structure
+                if (options.incomplete_inputs) {
+                    return nonstd::expected<void, std::string>(); // Success
+                }
+                return nonstd::unexpected<std::string>("Expected end of structure, got end of input");
+            }
+
+            switch (next) {
+                // Start of structure
+                case '{': case '[': {
+                    is_verbatim = false;
+                    nest_counter++;
+
+                    // Check exceeded max depth
+                    if (depth + nest_counter > options.max_depth) {
+                        return nonstd::unexpected<std::string>("Exceeded max depth");
+                    }
+                    break;
+                }
+                // End of structure
+                case '}': case ']': {
+                    is_verbatim = false;
+                    nest_counter--;
+                    if (nest_counter <= 0) {
+                        return nonstd::expected<void, std::string>(); // Success
+                    }
+                    break;
+                }
+                // Quoted string
+                case '"': case '\'': {
+                    nonstd::expected<void, std::string> skip_result = skip_quoted_string((char)next, is_verbatim);
+                    if (!skip_result) {
+                        return skip_result;
+                    }
+                    is_verbatim = false;
+                    break;
+                }
+                // Comment
+                case '#': case '/': {
+                    buffer->sungetc();
+                    nonstd::expected<void, std::string> skip_result = skip_comment();
+                    if (!skip_result) {
+                        return skip_result;
+                    }
+                    is_verbatim = false;
+                    break;
+                }
+                // Escape sequence (quoteless string)
+                case '\\': {
+                    if (!is_verbatim) {
+                        buffer->sbumpc();
+                    }
+                    break;
+                }
+                // Verbatim string
+                case '@': {
+                    is_verbatim = options.supports_version(jsonh_version::v2);
+                    break;
+                }
+                // End of verbatim quoteless string
+                case ',': case ':': case '\n': case '\r': {
+                    is_verbatim = false;
+                    break;
+                }
+                // End of verbatim quoteless string (\u2028, \u2029)
+                case 0xE2: {
+                    if (buffer->sgetc() == 0x80) {
+                        buffer->sbumpc();
+                        if (buffer->sgetc() == 0xA8 || buffer->sgetc() == 0xA9) {
+                            buffer->sbumpc();
+                            is_verbatim = false;
+                        }
+                    }
+                    break;
+                }
+                // Other
+                default: {
+                    break;
+                }
+            }
+        }
+    }
+    nonstd::expected<void, std::string> skip_quoted_string(char start_quote_char, bool is_verbatim) noexcept {
+        std::streambuf* buffer = inner_stream->rdbuf();
+        const int end_of_buffer = std::char_traits<char>::eof();
+
+        // Count multiple start quotes
+        size_t start_quote_counter = 1;
+        while (buffer->sgetc() == start_quote_char) {
+            buffer->sbumpc();
+            start_quote_counter++;
+        }
+
+        // Empty string
+        if (start_quote_counter == 2) {
+            return nonstd::expected<void, std::string>(); // Success
+        }
+
+        // Count multiple end quotes
+        size_t end_quote_counter = 0;
+
+        while (true) {
+            // Read byte
+            int next = buffer->sbumpc();
+            if (next == end_of_buffer) {
+                return nonstd::unexpected<std::string>("Expected end of string, got end of input");
+            }
+
+            // End quote
+            if (next == start_quote_char) {
+                end_quote_counter++;
+                if (end_quote_counter == start_quote_counter) {
+                    return nonstd::expected<void, std::string>(); // Success
+                }
+                continue;
+            }
+            end_quote_counter = 0;
+
+            // Escape sequence
+            if (next == '\\' && !is_verbatim) {
+                if (buffer->sbumpc() == end_of_buffer) {
+                    return nonstd::unexpected<std::string>("Expected escape sequence, got end of input");
+                }
+            }
+        }
+    }
+    std::generator<nonstd::expected<json, std::string>> select_next_element(const jsonh_query& query, std::vector<size_t> states, bool is_counting) noexcept {
+        // Comments & whitespace
+        nonstd::expected<void, std::string> skip_result = skip_comments_and_whitespace();
+        if (!skip_result) {
+            co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+            co_return;
+        }
+
+        bool is_match = query.is_match(states);
+        bool has_pending_states = query.has_pending_states(states);
+
+        // No selected descendants
+        if (!has_pending_states && (!is_match || is_counting)) {
+            skip_result = skip_element();
+            if (!skip_result) {
+                co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+                co_return;
+            }
+            if (is_match) {
+                co_yield(json());
+            }
+            co_return;
+        }
+        // Selected element (select descendants from parsed element)
+        if (is_match) {
+            nonstd::expected<json, std::string> element = parse_next_element();
+            if (!element) {
+                co_yield(nonstd::unexpected<std::string>(element.error()));
+                co_return;
+            }
+            std::vector<json> results;
+            query.select(element.value(), states, results);
+            for (json& result : results) {
+                co_yield(std::move(result));
+            }
+            co_return;
+        }
+
+        // Start structure
+        object_walk object;
+        nonstd::expected<char, std::string> structure = start_next_structure(object);
+        if (!structure) {
+            co_yield(nonstd::unexpected<std::string>(structure.error()));
+            co_return;
+        }
+
+        // Object
+        if (structure.value() == '{') {
+            for (nonstd::expected<json, std::string>&& result : select_next_properties(query, std::move(states), is_counting, std::move(object))) {
+                if (!result) {
+                    co_yield(std::move(result));
+                    co_return;
+                }
+                co_yield(std::move(result));
+            }
+        }
+        // Array
+        else if (structure.value() == '[') {
+            for (nonstd::expected<json, std::string>&& result : select_next_items(query, std::move(states), is_counting)) {
+                if (!result) {
+                    co_yield(std::move(result));
+                    co_return;
+                }
+                co_yield(std::move(result));
+            }
+        }
+        // Primitive
+        else {
+            skip_result = skip_element();
+            if (!skip_result) {
+                co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+            }
+        }
+    }
+    std::generator<nonstd::expected<json, std::string>> select_next_properties(const jsonh_query& query, std::vector<size_t> states, bool is_counting, object_walk object) noexcept {
+        // Results are buffered with last_wins so that a later duplicate property can replace them
+        bool is_buffering = options.duplicate_property_policy == jsonh_duplicate_property_policy::last_wins;
+        std::vector<std::pair<std::string, std::vector<json>>> buffered_results;
+        auto buffer_result = [&](const std::string& property_name, json&& result) -> void {
+            if (buffered_results.empty() || buffered_results.back().first != property_name) {
+                buffered_results.emplace_back(property_name, std::vector<json>());
+            }
+            buffered_results.back().second.push_back(std::move(result));
+        };
+
+        std::vector<size_t> property_states;
+        while (true) {
+            // Property name
+            nonstd::expected<std::optional<std::string>, std::string> next_property_name = read_next_property_name(object);
+            if (!next_property_name) {
+                co_yield(nonstd::unexpected<std::string>(next_property_name.error()));
+                co_return;
+            }
+            if (!next_property_name.value()) {
+                break;
+            }
+            std::string& property_name = next_property_name.value().value();
+
+            // Duplicate property replaces results of previous value (last_wins)
+            if (object.is_duplicate) {
+                std::erase_if(buffered_results, [&](const std::pair<std::string, std::vector<json>>& results) { return results.first == property_name; });
+            }
+
+            nonstd::expected<void, std::string> skip_result;
+            // Property value
+            if (query.next_states(states, &property_name, 0, nullptr, property_states)) {
+                // Unselected property value
+                if (property_states.empty()) {
+                    skip_result = skip_element();
+                    if (!skip_result) {
+                        co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+                        co_return;
+                    }
+                }
+                // Selected property value or its descendants
+                else {
+                    for (nonstd::expected<json, std::string>&& result : select_next_element(query, property_states, is_counting)) {
+                        if (!result) {
+                            co_yield(std::move(result));
+                            co_return;
+                        }
+                        if (is_buffering) {
+                            buffer_result(property_name, std::move(result.value()));
+                        }
+                        else {
+                            co_yield(std::move(result));
+                        }
+                    }
+                }
+            }
+            // Property value tested by filter
+            else {
+                nonstd::expected<json, std::string> property_value = parse_next_element();
+                if (!property_value) {
+                    co_yield(nonstd::unexpected<std::string>(property_value.error()));
+                    co_return;
+                }
+                query.next_states(states, &property_name, 0, &property_value.value(), property_states);
+                std::vector<json> results;
+                query.select(property_value.value(), property_states, results);
+                for (json& result : results) {
+                    if (is_buffering) {
+                        buffer_result(property_name, std::move(result));
+                    }
+                    else {
+                        co_yield(std::move(result));
+                    }
+                }
+            }
+
+            // End of property
+            skip_result = end_next_property_or_item();
+            if (!skip_result) {
+                co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+                co_return;
+            }
+        }
+
+        // Buffered results
+        for (std::pair<std::string, std::vector<json>>& results : buffered_results) {
+            for (json& result : results.second) {
+                co_yield(std::move(result));
+            }
+        }
+    }
+    std::generator<nonstd::expected<json, std::string>> select_next_items(const jsonh_query& query, std::vector<size_t> states, bool is_counting) noexcept {
+        std::vector<size_t> item_states;
+        for (size_t item_index = 0; ; item_index++) {
+            // Start of item
+            nonstd::expected<bool, std::string> has_item = read_next_item_start();
+            if (!has_item) {
+                co_yield(nonstd::unexpected<std::string>(has_item.error()));
+                co_return;
+            }
+            if (!has_item.value()) {
+                break;
+            }
+
+            nonstd::expected<void, std::string> skip_result;
+            // Item
+            if (query.next_states(states, nullptr, item_index, nullptr, item_states)) {
+                // Unselected item
+                if (item_states.empty()) {
+                    skip_result = skip_element();
+                    if (!skip_result) {
+                        co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+                        co_return;
+                    }
+                }
+                // Selected item or its descendants
+                else {
+                    for (nonstd::expected<json, std::string>&& result : select_next_element(query, item_states, is_counting)) {
+                        if (!result) {
+                            co_yield(std::move(result));
+                            co_return;
+                        }
+                        co_yield(std::move(result));
+                    }
+                }
+            }
+            // Item tested by filter
+            else {
+                nonstd::expected<json, std::string> item = parse_next_element();
+                if (!item) {
+                    co_yield(nonstd::unexpected<std::string>(item.error()));
+                    co_return;
+                }
+                query.next_states(states, nullptr, item_index, &item.value(), item_states);
+                std::vector<json> results;
+                query.select(item.value(), item_states, results);
+                for (json& result : results) {
+                    co_yield(std::move(result));
+                }
+            }
+
+            // End of item
+            skip_result = end_next_property_or_item();
+            if (!skip_result) {
+                co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+                co_return;
+            }
+        }
+    }
+    nonstd::expected<void, std::string> extract_next_element(const jsonh_extractor& extractor, size_t node_index, std::vector<std::optional<json>>& slots, size_t& remaining_count) noexcept {
+        // Comments & whitespace
+        nonstd::expected<void, std::string> skip_result = skip_comments_and_whitespace();
+        if (!skip_result) {
+            return nonstd::unexpected<std::string>(skip_result.error());
+        }
+
+        // Extracted element (extract descendants from parsed element)
+        if (extractor.nodes[node_index].slot != jsonh_extractor::no_slot) {
+            nonstd::expected<json, std::string> element = parse_next_element();
+            if (!element) {
+                return nonstd::unexpected<std::string>(element.error());
+            }
+            extractor.run(element.value(), node_index, slots, remaining_count);
+            return nonstd::expected<void, std::string>(); // Success
+        }
+
+        // Start structure
+        object_walk object;
+        nonstd::expected<char, std::string> structure = start_next_structure(object);
+        if (!structure) {
+            return nonstd::unexpected<std::string>(structure.error());
+        }
+
+        // Object
+        if (structure.value() == '{') {
+            return extract_next_properties(extractor, node_index, slots, remaining_count, object);
+        }
+        // Array
+        if (structure.value() == '[') {
+            return extract_next_items(extractor, node_index, slots, remaining_count);
+        }
+        // Primitive
+        return skip_element();
+    }
+    nonstd::expected<void, std::string> extract_next_properties(const jsonh_extractor& extractor, size_t node_index, std::vector<std::optional<json>>& slots, size_t& remaining_count,
+        object_walk& object) noexcept {
+
+        while (true) {
+            // Property name
+            nonstd::expected<std::optional<std::string>, std::string> property_name = read_next_property_name(object);
+            if (!property_name) {
+                return nonstd::unexpected<std::string>(property_name.error());
+            }
+            if (!property_name.value()) {
+                break;
+            }
+
+            nonstd::expected<void, std::string> skip_result;
+            size_t child_index = extractor.find_child(node_index, property_name.value().value());
+            // Property value not on any path
+            if (child_index == jsonh_extractor::no_node) {
+                skip_result = skip_element();
+            }
+            // Property value on a path
+            else {
+                // Duplicate property replaces previous value (last_wins)
+                if (object.is_duplicate) {
+                    extractor.clear(child_index, slots, remaining_count);
+                }
+                skip_result = extract_next_element(extractor, child_index, slots, remaining_count);
+            }
+            if (!skip_result) {
+                return nonstd::unexpected<std::string>(skip_result.error());
+            }
+
+            // Every slot filled (skip rest of object unless a later duplicate property could replace a value)
+            if (remaining_count == 0 && !object.is_braceless && options.duplicate_property_policy == jsonh_duplicate_property_policy::first_wins) {
+                depth--;
+                return skip_structure(1);
+            }
+
+            // End of property
+            skip_result = end_next_property_or_item();
+            if (!skip_result) {
+                return nonstd::unexpected<std::string>(skip_result.error());
+            }
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    nonstd::expected<void, std::string> extract_next_items(const jsonh_extractor& extractor, size_t node_index, std::vector<std::optional<json>>& slots, size_t& remaining_count) noexcept {
+        for (size_t item_index = 0; ; item_index++) {
+            // Start of item
+            nonstd::expected<bool, std::string> has_item = read_next_item_start();
+            if (!has_item) {
+                return nonstd::unexpected<std::string>(has_item.error());
+            }
+            if (!has_item.value()) {
+                break;
+            }
+
+            nonstd::expected<void, std::string> skip_result;
+            size_t child_index = extractor.find_child(node_index, std::to_string(item_index));
+            // Item not on any path
+            if (child_index == jsonh_extractor::no_node) {
+                skip_result = skip_element();
+            }
+            // Item on a path
+            else {
+                skip_result = extract_next_element(extractor, child_index, slots, remaining_count);
+            }
+            if (!skip_result) {
+                return nonstd::unexpected<std::string>(skip_result.error());
+            }
+
+            // Every slot filled (skip rest of array)
+            if (remaining_count == 0) {
+                depth--;
+                return skip_structure(1);
+            }
+
+            // End of item
+            skip_result = end_next_property_or_item();
+            if (!skip_result) {
+                return nonstd::unexpected<std::string>(skip_result.error());
+            }
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    nonstd::expected<bool, std::string> diff_next_element(jsonh_reader& other, const json::json_pointer& pointer, json* patch) noexcept {
+        size_t original_position = position();
+        size_t other_original_position = other.position();
+
+        // Start structures
+        object_walk object;
+        nonstd::expected<char, std::string> structure = start_next_structure(object);
+        if (!structure) {
+            return nonstd::unexpected<std::string>(structure.error());
+        }
+        object_walk other_object;
+        nonstd::expected<char, std::string> other_structure = other.start_next_structure(other_object);
+        if (!other_structure) {
+            return nonstd::unexpected<std::string>(other_structure.error());
+        }
+
+        // Objects
+        if (structure.value() == '{' && other_structure.value() == '{') {
+            return diff_next_properties(other, object, other_object, pointer, patch);
+        }
+        // Arrays
+        if (structure.value() == '[' && other_structure.value() == '[') {
+            return diff_next_items(other, pointer, patch);
+        }
+
+        // Primitives or different types (compare parsed elements)
+        if (structure.value() != '\0') {
+            depth--;
+        }
+        if (other_structure.value() != '\0') {
+            other.depth--;
+        }
+        seek(original_position);
+        other.seek(other_original_position);
+        nonstd::expected<json, std::string> element = parse_next_element();
+        if (!element) {
+            return nonstd::unexpected<std::string>(element.error());
+        }
+        nonstd::expected<json, std::string> other_element = other.parse_next_element();
+        if (!other_element) {
+            return nonstd::unexpected<std::string>(other_element.error());
+        }
+        if (element.value() == other_element.value()) {
+            return true;
+        }
+        if (patch) {
+            patch->push_back({ { "op", "replace" }, { "path", pointer.to_string() }, { "value", std::move(other_element.value()) } });
+        }
+        return false;
+    }
+    nonstd::expected<bool, std::string> diff_next_properties(jsonh_reader& other, object_walk& object, object_walk& other_object, const json::json_pointer& pointer, json* patch) noexcept {
+        size_t patch_size = patch ? patch->size() : 0;
+        bool is_equal = true;
+        while (true) {
+            // Property names
+            nonstd::expected<std::optional<std::string>, std::string> property_name = read_next_property_name(object);
+            if (!property_name) {
+                return nonstd::unexpected<std::string>(property_name.error());
+            }
+            nonstd::expected<std::optional<std::string>, std::string> other_property_name = other.read_next_property_name(other_object);
+            if (!other_property_name) {
+                return nonstd::unexpected<std::string>(other_property_name.error());
+            }
+
+            // Duplicate property names (compare both objects parsed)
+            if (object.has_duplicates || other_object.has_duplicates) {
+                return diff_next_parsed_properties(other, object, other_object, pointer, patch, patch_size);
+            }
+
+            // End of both objects
+            if (!property_name.value() && !other_property_name.value()) {
+                break;
+            }
+
+            // Same property name
+            if (property_name.value() && other_property_name.value() && property_name.value().value() == other_property_name.value().value()) {
+                nonstd::expected<bool, std::string> value_result = diff_next_element(other, pointer / property_name.value().value(), patch);
+                if (!value_result) {
+                    return nonstd::unexpected<std::string>(value_result.error());
+                }
+                if (!value_result.value()) {
+                    is_equal = false;
+                }
+
+                nonstd::expected<void, std::string> end_result = end_next_property_or_item();
+                if (!end_result) {
+                    return nonstd::unexpected<std::string>(end_result.error());
+                }
+                end_result = other.end_next_property_or_item();
+                if (!end_result) {
+                    return nonstd::unexpected<std::string>(end_result.error());
+                }
+
+                // Skip the rest of both objects (a later duplicate property could still replace the different value)
+                if (!is_equal && !patch) {
+                    end_result = skip_next_properties(object);
+                    if (!end_result) {
+                        return nonstd::unexpected<std::string>(end_result.error());
+                    }
+                    end_result = other.skip_next_properties(other_object);
+                    if (!end_result) {
+                        return nonstd::unexpected<std::string>(end_result.error());
+                    }
+                    if (object.has_duplicates || other_object.has_duplicates) {
+                        return diff_next_parsed_properties(other, object, other_object, pointer, patch, patch_size);
+                    }
+                    break;
+                }
+                continue;
+            }
+
+            // Different property names (compare the rest of both objects parsed)
+            json rest = json::object();
+            nonstd::expected<void, std::string> rest_result = parse_next_properties(std::move(property_name.value()), object, rest);
+            if (!rest_result) {
+                return nonstd::unexpected<std::string>(rest_result.error());
+            }
+            json other_rest = json::object();
+            rest_result = other.parse_next_properties(std::move(other_property_name.value()), other_object, other_rest);
+            if (!rest_result) {
+                return nonstd::unexpected<std::string>(rest_result.error());
+            }
+            if (object.has_duplicates || other_object.has_duplicates) {
+                return diff_next_parsed_properties(other, object, other_object, pointer, patch, patch_size);
+            }
+            if (rest != other_rest) {
+                is_equal = false;
+                if (patch) {
+                    for (json& operation : json::diff(rest, other_rest, pointer.to_string())) {
+                        patch->push_back(std::move(operation));
+                    }
+                }
+            }
+            break;
+        }
+        return is_equal;
+    }
+    nonstd::expected<bool, std::string> diff_next_parsed_properties(jsonh_reader& other, object_walk& object, object_walk& other_object, const json::json_pointer& pointer, json* patch, size_t patch_size) noexcept {
+        // Discard operations for properties read before the duplicate property name
+        if (patch) {
+            patch->erase(patch->begin() + patch_size, patch->end());
+        }
+
+        // Parse both objects with the duplicate property policy
+        restart_next_properties(object);
+        json element = json::object();
+        nonstd::expected<std::optional<std::string>, std::string> property_name = read_next_property_name(object);
+        if (!property_name) {
+            return nonstd::unexpected<std::string>(property_name.error());
+        }
+        nonstd::expected<void, std::string> parse_result = parse_next_properties(std::move(property_name.value()), object, element);
+        if (!parse_result) {
+            return nonstd::unexpected<std::string>(parse_result.error());
+        }
+        other.restart_next_properties(other_object);
+        json other_element = json::object();
+        nonstd::expected<std::optional<std::string>, std::string> other_property_name = other.read_next_property_name(other_object);
+        if (!other_property_name) {
+            return nonstd::unexpected<std::string>(other_property_name.error());
+        }
+        parse_result = other.parse_next_properties(std::move(other_property_name.value()), other_object, other_element);
+        if (!parse_result) {
+            return nonstd::unexpected<std::string>(parse_result.error());
+        }
+
+        if (element == other_element) {
+            return true;
+        }
+        if (patch) {
+            for (json& operation : json::diff(element, other_element, pointer.to_string())) {
+                patch->push_back(std::move(operation));
+            }
+        }
+        return false;
+    }
+    nonstd::expected<bool, std::string> diff_next_items(jsonh_reader& other, const json::json_pointer& pointer, json* patch) noexcept {
+        bool is_equal = true;
+        for (size_t item_index = 0; ; item_index++) {
+            // Start items
+            nonstd::expected<bool, std::string> has_item = read_next_item_start();
+            if (!has_item) {
+                return nonstd::unexpected<std::string>(has_item.error());
+            }
+            nonstd::expected<bool, std::string> other_has_item = other.read_next_item_start();
+            if (!other_has_item) {
+                return nonstd::unexpected<std::string>(other_has_item.error());
+            }
+
+            // End of both arrays
+            if (!has_item.value() && !other_has_item.value()) {
+                break;
+            }
+
+            // Both items
+            if (has_item.value() && other_has_item.value()) {
+                nonstd::expected<bool, std::string> item_result = diff_next_element(other, pointer / item_index, patch);
+                if (!item_result) {
+                    return nonstd::unexpected<std::string>(item_result.error());
+                }
+                if (!item_result.value()) {
+                    is_equal = false;
+                }
+
+                nonstd::expected<void, std::string> end_result = end_next_property_or_item();
+                if (!end_result) {
+                    return nonstd::unexpected<std::string>(end_result.error());
+                }
+                end_result = other.end_next_property_or_item();
+                if (!end_result) {
+                    return nonstd::unexpected<std::string>(end_result.error());
+                }
+
+                // Skip the rest of both arrays
+                if (!is_equal && !patch) {
+                    depth--;
+                    end_result = skip_structure(1);
+                    if (!end_result) {
+                        return nonstd::unexpected<std::string>(end_result.error());
+                    }
+                    other.depth--;
+                    end_result = other.skip_structure(1);
+                    if (!end_result) {
+                        return nonstd::unexpected<std::string>(end_result.error());
+                    }
+                    return false;
+                }
+                continue;
+            }
+
+            // Skip the rest of the longer array
+            if (!patch) {
+                jsonh_reader& longer = has_item.value() ? *this : other;
+                longer.depth--;
+                nonstd::expected<void, std::string> skip_result = longer.skip_structure(1);
+                if (!skip_result) {
+                    return nonstd::unexpected<std::string>(skip_result.error());
+                }
+                return false;
+            }
+            is_equal = false;
+
+            // Added items
+            if (other_has_item.value()) {
+                for (; other_has_item.value(); item_index++) {
+                    nonstd::expected<json, std::string> item = other.parse_next_element();
+                    if (!item) {
+                        return nonstd::unexpected<std::string>(item.error());
+                    }
+                    patch->push_back({ { "op", "add" }, { "path", (pointer / item_index).to_string() }, { "value", std::move(item.value()) } });
+
+                    nonstd::expected<void, std::string> end_result = other.end_next_property_or_item();
+                    if (!end_result) {
+                        return nonstd::unexpected<std::string>(end_result.error());
+                    }
+                    other_has_item = other.read_next_item_start();
+                    if (!other_has_item) {
+                        return nonstd::unexpected<std::string>(other_has_item.error());
+                    }
+                }
+            }
+            // Removed items (remove from the end so indexes stay valid)
+            else {
+                size_t removed_count = 0;
+                for (; has_item.value(); removed_count++) {
+                    nonstd::expected<void, std::string> skip_result = skip_element();
+                    if (!skip_result) {
+                        return nonstd::unexpected<std::string>(skip_result.error());
+                    }
+
+                    skip_result = end_next_property_or_item();
+                    if (!skip_result) {
+                        return nonstd::unexpected<std::string>(skip_result.error());
+                    }
+                    has_item = read_next_item_start();
+                    if (!has_item) {
+                        return nonstd::unexpected<std::string>(has_item.error());
+                    }
+                }
+                for (size_t removed_index = removed_count; removed_index-- > 0;) {
+                    patch->push_back({ { "op", "remove" }, { "path", (pointer / (item_index + removed_index)).to_string() } });
+                }
+            }
+            break;
+        }
+        return is_equal;
+    }
+    nonstd::expected<char, std::string> start_next_structure(object_walk& object) noexcept {
+        // Comments & whitespace
+        nonstd::expected<void, std::string> skip_result = skip_comments_and_whitespace();
+        if (!skip_result) {
+            return nonstd::unexpected<std::string>(skip_result.error());
+        }
+
+        // Peek rune
+        std::optional<std::string> next = peek();
+        if (!next) {
+            return nonstd::unexpected<std::string>("Expected token, got end of input");
+        }
+
+        char structure = '\0';
+        size_t original_position = position();
+        // Object
+        if (next.value() == "{") {
+            read();
+            structure = '{';
+        }
+        // Array
+        else if (next.value() == "[") {
+            read();
+            structure = '[';
+        }
+        // Braceless object
+        else if (depth == 0) {
+            for (nonstd::expected<jsonh_token, std::string>&& token : read_property_name()) {
+                if (!token) {
+                    break;
+                }
+                if (token.value().json_type == json_token_type::property_name) {
+                    object.braceless_property_name = std::move(token.value().value);
+                }
+            }
+            if (object.braceless_property_name) {
+                object.is_braceless = true;
+                structure = '{';
+            }
+        }
+
+        // Primitive
+        if (structure == '\0') {
+            seek(original_position);
+            return structure;
+        }
+
+        depth++;
+        object.start_position = object.is_braceless ? original_position : position();
+        object.depth = depth;
+
+        // Check exceeded max depth
+        if (depth > options.max_depth) {
+            return nonstd::unexpected<std::string>("Exceeded max depth");
+        }
+        return structure;
+    }
+    nonstd::expected<std::optional<std::string>, std::string> read_next_property_name(object_walk& object) noexcept {
+        while (true) {
+            // Comments & whitespace
+            nonstd::expected<void, std::string> skip_result = skip_comments_and_whitespace();
+            if (!skip_result) {
+                return nonstd::unexpected<std::string>(skip_result.error());
+            }
+
+            std::string property_name;
+            // First property name of braceless object
+            if (object.braceless_property_name) {
+                property_name = std::move(object.braceless_property_name.value());
+                object.braceless_property_name.reset();
+            }
+            else {
+                std::optional<std::string> next = peek();
+                if (!next) {
+                    // End of braceless or incomplete object
+                    if (object.is_braceless || options.incomplete_inputs) {
+                        depth--;
+                        return std::nullopt;
+                    }
+                    // Missing closing brace
+                    return nonstd::unexpected<std::string>("Expected `}` to end object, got end of input");
+                }
+                // Closing brace
+                if (!object.is_braceless && next.value() == "}") {
+                    read();
+                    depth--;
+                    return std::nullopt;
+                }
+
+                for (nonstd::expected<jsonh_token, std::string>&& token : read_property_name()) {
+                    if (!token) {
+                        return nonstd::unexpected<std::string>(token.error());
+                    }
+                    if (token.value().json_type == json_token_type::property_name) {
+                        property_name = std::move(token.value().value);
+                    }
+                }
+            }
+
+            // Duplicate property name
+            object.is_duplicate = !object.property_names.insert(property_name);
+            if (object.is_duplicate) {
+                // Error
+                if (options.duplicate_property_policy == jsonh_duplicate_property_policy::error) {
+                    return nonstd::unexpected<std::string>("Duplicate property name");
+                }
+                // Skip value (first_wins)
+                if (options.duplicate_property_policy == jsonh_duplicate_property_policy::first_wins) {
+                    skip_result = skip_element();
+                    if (!skip_result) {
+                        return nonstd::unexpected<std::string>(skip_result.error());
+                    }
+                    skip_result = end_next_property_or_item();
+                    if (!skip_result) {
+                        return nonstd::unexpected<std::string>(skip_result.error());
+                    }
+                    continue;
+                }
+                object.has_duplicates = true;
+            }
+
+            // Comments & whitespace
+            skip_result = skip_comments_and_whitespace();
+            if (!skip_result) {
+                return nonstd::unexpected<std::string>(skip_result.error());
+            }
+            return property_name;
+        }
+    }
+    nonstd::expected<bool, std::string> read_next_item_start() noexcept {
+        // Comments & whitespace
+        nonstd::expected<void, std::string> skip_result = skip_comments_and_whitespace();
+        if (!skip_result) {
+            return nonstd::unexpected<std::string>(skip_result.error());
+        }
+
+        std::optional<std::string> next = peek();
+        if (!next) {
+            // End of incomplete array
+            if (options.incomplete_inputs) {
+                depth--;
+                return false;
+            }
+            // Missing closing bracket
+            return nonstd::unexpected<std::string>("Expected `]` to end array, got end of input");
+        }
+        // Closing bracket
+        if (next.value() == "]") {
+            read();
+            depth--;
+            return false;
+        }
+        return true;
+    }
+    nonstd::expected<void, std::string> end_next_property_or_item() noexcept {
+        // Comments & whitespace
+        nonstd::expected<void, std::string> skip_result = skip_comments_and_whitespace();
+        if (!skip_result) {
+            return nonstd::unexpected<std::string>(skip_result.error());
+        }
+
+        // Optional comma
+        read_one(",");
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    void restart_next_properties(object_walk& object) noexcept {
+        seek(object.start_position);
+        depth = object.depth;
+        object.braceless_property_name.reset();
+        object.property_names.clear();
+        object.is_duplicate = false;
+        object.has_duplicates = false;
+    }
+    nonstd::expected<void, std::string> skip_next_properties(object_walk& object) noexcept {
+        while (true) {
+            // Property name
+            nonstd::expected<std::optional<std::string>, std::string> property_name = read_next_property_name(object);
+            if (!property_name) {
+                return nonstd::unexpected<std::string>(property_name.error());
+            }
+            if (!property_name.value()) {
+                return nonstd::expected<void, std::string>(); // Success
+            }
+
+            // Property value
+            nonstd::expected<void, std::string> skip_result = skip_element();
+            if (!skip_result) {
+                return skip_result;
+            }
+            skip_result = end_next_property_or_item();
+            if (!skip_result) {
+                return skip_result;
+            }
+        }
+    }
+    nonstd::expected<void, std::string> parse_next_properties(std::optional<std::string> property_name, object_walk& object, json& element) noexcept {
+        json::object_t& properties = element.get_ref<json::object_t&>();
+        std::set<std::string> collected_property_names;
+        while (property_name) {
+            // Property value
+            nonstd::expected<json, std::string> property_value = parse_next_element();
+            if (!property_value) {
+                return nonstd::unexpected<std::string>(property_value.error());
+            }
+
+            // Collect values into array
+            if (object.is_duplicate && options.duplicate_property_policy == jsonh_duplicate_property_policy::collect) {
+                json& collected_value = properties[property_name.value()];
+                if (collected_property_names.insert(property_name.value()).second) {
+                    collected_value = json::array({ std::move(collected_value) });
+                }
+                collected_value.push_back(std::move(property_value.value()));
+            }
+            // Replace value (duplicates are already skipped or errors with other policies)
+            else {
+                properties.insert_or_assign(std::move(property_name.value()), std::move(property_value.value()));
+            }
+
+            nonstd::expected<void, std::string> end_result = end_next_property_or_item();
+            if (!end_result) {
+                return nonstd::unexpected<std::string>(end_result.error());
+            }
+
+            // Next property name
+            nonstd::expected<std::optional<std::string>, std::string> next_property_name = read_next_property_name(object);
+            if (!next_property_name) {
+                return nonstd::unexpected<std::string>(next_property_name.error());
+            }
+            property_name = std::move(next_property_name.value());
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    nonstd::expected<uint64_t, std::string> hash_next_element() noexcept {
+        // Start structure
+        object_walk object;
+        nonstd::expected<char, std::string> structure = start_next_structure(object);
+        if (!structure) {
+            return nonstd::unexpected<std::string>(structure.error());
+        }
+
+        // Object
+        if (structure.value() == '{') {
+            std::vector<std::pair<std::string, uint64_t>> property_hashes;
+            while (true) {
+                // Property name
+                nonstd::expected<std::optional<std::string>, std::string> property_name = read_next_property_name(object);
+                if (!property_name) {
+                    return nonstd::unexpected<std::string>(property_name.error());
+                }
+                if (!property_name.value()) {
+                    break;
+                }
+
+                // Property value
+                nonstd::expected<uint64_t, std::string> value_hash = hash_next_element();
+                if (!value_hash) {
+                    return value_hash;
+                }
+                property_hashes.emplace_back(std::move(property_name.value().value()), value_hash.value());
+
+                // End of property
+                nonstd::expected<void, std::string> end_result = end_next_property_or_item();
+                if (!end_result) {
+                    return nonstd::unexpected<std::string>(end_result.error());
+                }
+            }
+
+            // Group properties with the same name
+            std::stable_sort(property_hashes.begin(), property_hashes.end(), [](const std::pair<std::string, uint64_t>& a, const std::pair<std::string, uint64_t>& b) {
+                return a.first < b.first;
+            });
+            uint64_t property_hash_sum = 0;
+            size_t property_count = 0;
+            for (size_t index = 0; index < property_hashes.size();) {
+                size_t group_end = index + 1;
+                while (group_end < property_hashes.size() && property_hashes[group_end].first == property_hashes[index].first) {
+                    group_end++;
+                }
+
+                // Apply duplicate property policy (duplicates are already skipped or errors with first_wins and error)
+                uint64_t value_hash = property_hashes[group_end - 1].second;
+                if (options.duplicate_property_policy == jsonh_duplicate_property_policy::collect && group_end - index > 1) {
+                    uint64_t array_state = jsonh_semantic_hasher::start_array();
+                    for (size_t group_index = index; group_index < group_end; group_index++) {
+                        array_state = jsonh_semantic_hasher::add_item(array_state, property_hashes[group_index].second);
+                    }
+                    value_hash = jsonh_semantic_hasher::end_array(array_state);
+                }
+
+                property_hash_sum += jsonh_semantic_hasher::hash_property(property_hashes[index].first, value_hash);
+                property_count++;
+                index = group_end;
+            }
+            return jsonh_semantic_hasher::end_object(property_hash_sum, property_count);
+        }
+        // Array
+        if (structure.value() == '[') {
+            uint64_t array_state = jsonh_semantic_hasher::start_array();
+            while (true) {
+                // Start of item
+                nonstd::expected<bool, std::string> has_item = read_next_item_start();
+                if (!has_item) {
+                    return nonstd::unexpected<std::string>(has_item.error());
+                }
+                if (!has_item.value()) {
+                    break;
+                }
+
+                // Item
+                nonstd::expected<uint64_t, std::string> item_hash = hash_next_element();
+                if (!item_hash) {
+                    return item_hash;
+                }
+                array_state = jsonh_semantic_hasher::add_item(array_state, item_hash.value());
+
+                // End of item
+                nonstd::expected<void, std::string> end_result = end_next_property_or_item();
+                if (!end_result) {
+                    return nonstd::unexpected<std::string>(end_result.error());
+                }
+            }
+            return jsonh_semantic_hasher::end_array(array_state);
+        }
+
+        // Primitive
+        nonstd::expected<jsonh_token, std::string> token = read_primitive_element();
+        if (!token) {
+            return nonstd::unexpected<std::string>(token.error());
+        }
+        switch (token.value().json_type) {
+            // Null
+            case json_token_type::null: {
+                return jsonh_semantic_hasher::hash_null();
+            }
+            // True
+            case json_token_type::true_bool: {
+                return jsonh_semantic_hasher::hash_bool(true);
+            }
+            // False
+            case json_token_type::false_bool: {
+                return jsonh_semantic_hasher::hash_bool(false);
+            }
+            // String
+            case json_token_type::string: {
+                return jsonh_semantic_hasher::hash_string(token.value().value);
+            }
+            // Number
+            case json_token_type::number: {
+                nonstd::expected<long double, std::string> result = jsonh_number_parser::parse(token.value().value);
+                if (!result) {
+                    return nonstd::unexpected<std::string>(result.error());
+                }
+                return jsonh_semantic_hasher::hash_number((double)result.value());
+            }
+            // Not implemented
+            default: {
+                return nonstd::unexpected<std::string>("Token type not implemented");
+            }
+        }
+    }
+    nonstd::expected<void, std::string> write_next_canonical_element(std::ostream& output) noexcept {
+        nonstd::expected<void, std::string> result = write_next_canonical_element(&output, nullptr);
+        if (result && !output) {
+            return nonstd::unexpected<std::string>("Failed to write canonical JSON");
+        }
+        return result;
+    }
+    nonstd::expected<void, std::string> write_next_canonical_element(std::ostream* output, std::string* buffer) noexcept {
+        // Write to the buffer of the innermost object property, or to the output
+        auto write = [&](std::string_view text) -> void {
+            if (buffer) {
+                buffer->append(text);
+            }
+            else {
+                output->write(text.data(), text.size());
+            }
+        };
+
+        // Start structure
+        object_walk object;
+        nonstd::expected<char, std::string> structure = start_next_structure(object);
+        if (!structure) {
+            return nonstd::unexpected<std::string>(structure.error());
+        }
+
+        // Object (buffered to sort properties)
+        if (structure.value() == '{') {
+            std::vector<std::pair<std::string, std::vector<std::string>>> properties;
+            while (true) {
+                // Property name
+                nonstd::expected<std::optional<std::string>, std::string> property_name = read_next_property_name(object);
+                if (!property_name) {
+                    return nonstd::unexpected<std::string>(property_name.error());
+                }
+                if (!property_name.value()) {
+                    break;
+                }
+
+                // Property value
+                std::string value;
+                nonstd::expected<void, std::string> result = write_next_canonical_element(nullptr, &value);
+                if (!result) {
+                    return result;
+                }
+
+                // Apply duplicate property policy (duplicates are already skipped or errors with first_wins and error)
+                if (object.is_duplicate) {
+                    std::vector<std::pair<std::string, std::vector<std::string>>>::iterator property = std::find_if(properties.begin(), properties.end(),
+                        [&](const std::pair<std::string, std::vector<std::string>>& property) { return property.first == property_name.value().value(); });
+                    // Collect values into array
+                    if (options.duplicate_property_policy == jsonh_duplicate_property_policy::collect) {
+                        property->second.push_back(std::move(value));
+                    }
+                    // Replace value
+                    else {
+                        property->second.back() = std::move(value);
+                    }
+                }
+                else {
+                    properties.emplace_back(std::move(property_name.value().value()), std::vector<std::string>({ std::move(value) }));
+                }
+
+                // End of property
+                result = end_next_property_or_item();
+                if (!result) {
+                    return result;
+                }
+            }
+
+            // Sort by UTF-16 code units
+            std::vector<std::pair<std::u16string, size_t>> sort_keys;
+            sort_keys.reserve(properties.size());
+            for (size_t index = 0; index < properties.size(); index++) {
+                sort_keys.emplace_back(to_utf16(properties[index].first), index);
+            }
+            std::sort(sort_keys.begin(), sort_keys.end());
+
+            write("{");
+            for (size_t index = 0; index < sort_keys.size(); index++) {
+                std::pair<std::string, std::vector<std::string>>& property = properties[sort_keys[index].second];
+                if (index > 0) {
+                    write(",");
+                }
+                write(json(property.first).dump());
+                write(":");
+
+                // Single value
+                if (property.second.size() == 1) {
+                    write(property.second[0]);
+                }
+                // Collected values
+                else {
+                    write("[");
+                    for (size_t value_index = 0; value_index < property.second.size(); value_index++) {
+                        if (value_index > 0) {
+                            write(",");
+                        }
+                        write(property.second[value_index]);
+                    }
+                    write("]");
+                }
+            }
+            write("}");
+            return nonstd::expected<void, std::string>(); // Success
+        }
+        // Array
+        if (structure.value() == '[') {
+            write("[");
+            for (size_t item_index = 0; ; item_index++) {
+                // Start of item
+                nonstd::expected<bool, std::string> has_item = read_next_item_start();
+                if (!has_item) {
+                    return nonstd::unexpected<std::string>(has_item.error());
+                }
+                if (!has_item.value()) {
+                    break;
+                }
+
+                // Item
+                if (item_index > 0) {
+                    write(",");
+                }
+                nonstd::expected<void, std::string> result = write_next_canonical_element(output, buffer);
+                if (!result) {
+                    return result;
+                }
+
+                // End of item
+                result = end_next_property_or_item();
+                if (!result) {
+                    return result;
+                }
+            }
+            write("]");
+            return nonstd::expected<void, std::string>(); // Success
+        }
+
+        // Primitive
+        nonstd::expected<jsonh_token, std::string> token = read_primitive_element();
+        if (!token) {
+            return nonstd::unexpected<std::string>(token.error());
+        }
+        switch (token.value().json_type) {
+            // Null
+            case json_token_type::null: {
+                write("null");
+                break;
+            }
+            // True
+            case json_token_type::true_bool: {
+                write("true");
+                break;
+            }
+            // False
+            case json_token_type::false_bool: {
+                write("false");
+                break;
+            }
+            // String
+            case json_token_type::string: {
+                write(json(token.value().value).dump());
+                break;
+            }
+            // Number
+            case json_token_type::number: {
+                nonstd::expected<long double, std::string> result = jsonh_number_parser::parse(token.value().value);
+                if (!result) {
+                    return nonstd::unexpected<std::string>(result.error());
+                }
+                nonstd::expected<std::string, std::string> number = format_canonical_number((double)result.value());
+                if (!number) {
+                    return nonstd::unexpected<std::string>(number.error());
+                }
+                write(number.value());
+                break;
+            }
+            // Not implemented
+            default: {
+                return nonstd::unexpected<std::string>("Token type not implemented");
+            }
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
+    static nonstd::expected<std::string, std::string> format_canonical_number(double number) noexcept {
+        // Non-finite numbers
+        if (!std::isfinite(number)) {
+            return nonstd::unexpected<std::string>("Canonical JSON cannot represent non-finite number");
+        }
+        // Zero (including negative zero)
+        if (number == 0) {
+            return std::string("0");
+        }
+
+        // Shortest round-trip digits and exponent
+        std::array<char, 32> buffer;
+        std::to_chars_result result = std::to_chars(buffer.data(), buffer.data() + buffer.size(), std::abs(number), std::chars_format::scientific);
+        std::string_view scientific(buffer.data(), result.ptr - buffer.data());
+        size_t exponent_index = scientific.find('e');
+        std::string digits;
+        for (char next : scientific.substr(0, exponent_index)) {
+            if (next != '.') {
+                digits.push_back(next);
+            }
+        }
+        int exponent = 0;
+        std::string_view exponent_text = scientific.substr(exponent_index + 1);
+        if (exponent_text[0] == '+') {
+            exponent_text.remove_prefix(1);
+        }
+        std::from_chars(exponent_text.data(), exponent_text.data() + exponent_text.size(), exponent);
+
+        // Format like ECMAScript Number.prototype.toString (position of decimal point is point_index)
+        int digit_count = (int)digits.size();
+        int point_index = exponent + 1;
+        std::string formatted = number < 0 ? "-" : "";
+        // Integer
+        if (digit_count <= point_index && point_index <= 21) {
+            formatted.append(digits);
+            formatted.append(point_index - digit_count, '0');
+        }
+        // Fraction with integer part
+        else if (0 < point_index && point_index <= 21) {
+            formatted.append(digits, 0, point_index);
+            formatted.push_back('.');
+            formatted.append(digits, point_index);
+        }
+        // Fraction without integer part
+        else if (-6 < point_index && point_index <= 0) {
+            formatted.append("0.");
+            formatted.append(-point_index, '0');
+            formatted.append(digits);
+        }
+        // Exponent
+        else {
+            formatted.push_back(digits[0]);
+            if (digit_count > 1) {
+                formatted.push_back('.');
+                formatted.append(digits, 1);
+            }
+            formatted.push_back('e');
+            formatted.push_back(point_index - 1 < 0 ? '-' : '+');
+            formatted.append(std::to_string(std::abs(point_index - 1)));
+        }
+        return formatted;
+    }
+    static std::u16string to_utf16(std::string_view utf8) noexcept {
+        std::u16string utf16;
+        utf16.reserve(utf8.size());
+        for (size_t index = 0; index < utf8.size();) {
+            std::uint8_t first = (std::uint8_t)utf8[index];
+            size_t sequence_length = first < 0x80 ? 1 : (first < 0xE0 ? 2 : (first < 0xF0 ? 3 : 4));
+            char32_t code_point = sequence_length == 1 ? first : (first & (0x7F >> sequence_length));
+            for (size_t continuation = 1; continuation < sequence_length && index + continuation < utf8.size(); continuation++) {
+                code_point = (code_point << 6) | ((std::uint8_t)utf8[index + continuation] & 0x3F);
+            }
+            index += sequence_length;
+
+            // Surrogate pair
+            if (code_point >= 0x10000) {
+                code_point -= 0x10000;
+                utf16.push_back((char16_t)(0xD800 + (code_point >> 10)));
+                utf16.push_back((char16_t)(0xDC00 + (code_point & 0x3FF)));
+            }
+            else {
+                utf16.push_back((char16_t)code_point);
+            }
+        }
+        return utf16;
+    }
+    nonstd::expected<void, std::string> transcode_next_element(jsonh_binary_writer& writer) noexcept {
+        for (const nonstd::expected<jsonh_token, std::string>& token_result : read_element()) {
+            // Check error
+            if (!token_result) {
+                return nonstd::unexpected<std::string>(token_result.error());
+            }
+
+            // Write token
+            nonstd::expected<void, std::string> write_result = writer.write_token(token_result.value());
+            if (!write_result) {
+                return write_result;
+            }
+
+            // End of element
+            if (writer.is_complete()) {
+                return nonstd::expected<void, std::string>(); // Success
+            }
+        }
+
+        // End of input
+        return nonstd::unexpected<std::string>("Expected token, got end of input");
+    }
+    template <typename SAX>
+    bool sax_parse_next_element(SAX* sax) {
+        int64_t current_depth = 0;
+
+        // Property names in each object and depth of skipped property (for jsonh_duplicate_property_policy::first_wins)
+        std::vector<property_name_set> current_property_name_sets;
+        int64_t skipped_property_depth = -1;
+
+        for (nonstd::expected<jsonh_token, std::string>&& token_result : read_element()) {
+            // Check error
+            if (!token_result) {
+                return sax->parse_error(position(), "", json::parse_error::create(101, position(), token_result.error(), nullptr));
+            }
+            jsonh_token& token = token_result.value();
+
+            // Skip duplicate property
+            if (skipped_property_depth >= 0) {
+                if (token.json_type == json_token_type::start_object || token.json_type == json_token_type::start_array) {
+                    current_depth++;
+                }
+                else if (token.json_type == json_token_type::end_object || token.json_type == json_token_type::end_array) {
+                    current_depth--;
+                }
+                // End of property value
+                if (current_depth == skipped_property_depth && token.json_type != json_token_type::start_object && token.json_type != json_token_type::start_array
+                    && token.json_type != json_token_type::property_name && token.json_type != json_token_type::comment) {
+                    skipped_property_depth = -1;
+                }
+                continue;
+            }
+            if (options.duplicate_property_policy == jsonh_duplicate_property_policy::first_wins) {
+                // Start of object
+                if (token.json_type == json_token_type::start_object) {
+                    if (current_property_name_sets.size() <= (size_t)current_depth) {
+                        current_property_name_sets.resize(current_depth + 1);
+                    }
+                    current_property_name_sets[current_depth].clear();
+                }
+                // Duplicate property name
+                else if (token.json_type == json_token_type::property_name && !current_property_name_sets[current_depth - 1].insert(token.value)) {
+                    skipped_property_depth = current_depth;
+                    continue;
+                }
+            }
+
+            bool is_continuing = true;
+            switch (token.json_type) {
+                // Null
+                case json_token_type::null: {
+                    is_continuing = sax->null();
+                    break;
+                }
+                // True
+                case json_token_type::true_bool: {
+                    is_continuing = sax->boolean(true);
+                    break;
+                }
+                // False
+                case json_token_type::false_bool: {
+                    is_continuing = sax->boolean(false);
+                    break;
+                }
+                // String
+                case json_token_type::string: {
+                    is_continuing = sax->string(token.value);
                     break;
                 }
                 // Number
                 case json_token_type::number: {
+                    // Integer (parsed exactly, since long double may only be as precise as double)
+                    uint64_t magnitude = 0;
+                    bool is_negative = false;
+                    if (is_integer_number(token.value) && parse_integer_number(token.value, magnitude, is_negative)) {
+                        // Unsigned integer
+                        if (!is_negative || magnitude == 0) {
+                            is_continuing = sax->number_unsigned((json::number_unsigned_t)magnitude);
+                            break;
+                        }
+                        // Signed integer
+                        if (magnitude <= (uint64_t)INT64_MAX + 1) {
+                            is_continuing = sax->number_integer((json::number_integer_t)(0 - magnitude));
+                            break;
+                        }
+                    }
+
+                    // Float (or integer out of range)
                     nonstd::expected<long double, std::string> result = jsonh_number_parser::parse(token.value);
                     if (!result) {
-                        return nonstd::unexpected<std::string>(result.error());
-                    }
-                    result_builder.append(json(result.value()).dump());
-                    if (current_depth == 0) {
-                        return result_builder;
+                        return sax->parse_error(token.position, token.value, json::parse_error::create(101, token.position, result.error(), nullptr));
                     }
+                    is_continuing = sax->number_float((json::number_float_t)result.value(), token.value);
                     break;
                 }
                 // Start Object
                 case json_token_type::start_object: {
-                    result_builder.push_back('{');
                     current_depth++;
+                    is_continuing = sax->start_object(static_cast<size_t>(-1));
                     break;
                 }
                 // Start Array
                 case json_token_type::start_array: {
-                    result_builder.push_back('[');
                     current_depth++;
+                    is_continuing = sax->start_array(static_cast<size_t>(-1));
                     break;
                 }
                 // End Object
                 case json_token_type::end_object: {
-                    result_builder.push_back('}');
                     current_depth--;
-                    if (current_depth == 0) {
-                        return result_builder;
-                    }
+                    is_continuing = sax->end_object();
                     break;
                 }
                 // End Array
                 case json_token_type::end_array: {
-                    result_builder.push_back(']');
                     current_depth--;
-                    if (current_depth == 0) {
-                        return result_builder;
-                    }
+                    is_continuing = sax->end_array();
                     break;
                 }
                 // Property Name
                 case json_token_type::property_name: {
-                    result_builder.append(json(token.value).dump());
-                    result_builder.push_back(':');
-                    if (indent) {
-                        result_builder.push_back(' ');
-                    }
+                    is_continuing = sax->key(token.value);
                     break;
                 }
                 // Comment
                 case json_token_type::comment: {
-                    if (include_comments) {
-                        result_builder.append("/*");
-                        std::string comment_value = token.value;
-                        replace_all(comment_value, "/*", "/ *");
-                        replace_all(comment_value, "*/", "* /");
-                        result_builder.append(comment_value);
-                        result_builder.append("*/");
-                    }
-                    break;
+                    continue;
                 }
                 // Not implemented
                 default: {
-                    return nonstd::unexpected<std::string>("Token type not implemented");
+                    return sax->parse_error(token.position, "", json::parse_error::create(101, token.position, "Token type not implemented", nullptr));
                 }
             }
 
-            is_property_value = token.json_type == json_token_type::property_name;
-        }
-
-        // End of input
-        return nonstd::unexpected<std::string>("Expected token, got end of input");
-    }
-    /**
-    * @brief Tries to find the given property name in the reader.
-    * 
-    * For example, to find @c c:
-    * 
-    * @code{.jsonh}
-    * // Original position
-    * {
-    *   "a": "1",
-    *   "b": {
-    *     "c": "2"
-    *   },
-    *   "c": // Final position
-    *        "3"
-    * }
-    * @endcode
-    **/
-    bool find_property_value(const std::string& property_name) noexcept {
-        int64_t current_depth = 0;
-
-        for (const nonstd::expected<jsonh_token, std::string>& token_result : read_element()) {
-            // Check error
-            if (!token_result) {
+            // Stopped by handler
+            if (!is_continuing) {
                 return false;
             }
-
-            switch (token_result.value().json_type) {
-                // Start structure
-                case json_token_type::start_object: case json_token_type::start_array: {
-                    current_depth++;
-                    break;
-                }
-                // End structure
-                case json_token_type::end_object: case json_token_type::end_array: {
-                    current_depth--;
-                    break;
-                }
-                // Property name
-                case json_token_type::property_name: {
-                    if (current_depth == 1 && token_result.value().value == property_name) {
-                        // Path found
-                        return true;
-                    }
-                    break;
-                }
-                // Other
-                default: {
-                    break;
-                }
-            }
-        }
-
-        // Path not found
-        return false;
-    }
-    /**
-    * @brief Reads whitespace and returns whether the reader contains another token.
-    **/
-    bool has_token() noexcept {
-        // Whitespace
-        read_whitespace();
-
-        // Peek char
-        return !!peek();
-    }
-    /**
-    * @brief Reads comments and whitespace and errors if the reader contains another element.
-    **/
-    std::generator<nonstd::expected<jsonh_token, std::string>> read_end_of_elements() noexcept {
-        // Comments & whitespace
-        for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
-            if (!token) {
-                co_yield(token);
-                co_return;
-            }
-            co_yield(token);
-        }
-
-        // Peek char
-        if (!!peek()) {
-            co_yield(nonstd::unexpected<std::string>("Expected end of elements"));
-            co_return;
-        }
-    }
-    /**
-    * @brief Reads a single element from the reader.
-    **/
-    std::generator<nonstd::expected<jsonh_token, std::string>> read_element() noexcept {
-        // Comments & whitespace
-        for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
-            if (!token) {
-                co_yield(token);
-                co_return;
-            }
-            co_yield(token);
-        }
-
-        // Peek rune
-        std::optional<std::string> next = peek();
-        if (!next) {
-            co_yield(nonstd::unexpected<std::string>("Expected token, got end of input"));
-            co_return;
-        }
-
-        // Object
-        if (next.value() == "{") {
-            for (const nonstd::expected<jsonh_token, std::string>& token : read_object()) {
-                if (!token) {
-                    co_yield(token);
-                    co_return;
-                }
-                co_yield(token);
-            }
-        }
-        // Array
-        else if (next.value() == "[") {
-            for (const nonstd::expected<jsonh_token, std::string>& token : read_array()) {
-                if (!token) {
-                    co_yield(token);
-                    co_return;
-                }
-                co_yield(token);
+            // End of element
+            if (current_depth == 0 && token.json_type != json_token_type::property_name) {
+                return true;
             }
         }
-        // Primitive value (null, true, false, string, number)
-        else {
-            nonstd::expected<jsonh_token, std::string> token = read_primitive_element();
-            if (!token) {
-                co_yield(nonstd::unexpected<std::string>(token.error()));
-                co_return;
-            }
 
-            // Detect braceless object from property name
-            for (const nonstd::expected<jsonh_token, std::string>& token2 : read_braceless_object_or_end_of_primitive(token.value())) {
-                if (!token2) {
-                    co_yield(token2);
-                    co_return;
-                }
-                co_yield(token2);
-            }
-        }
+        // End of input
+        return sax->parse_error(position(), "", json::parse_error::create(101, position(), "Expected token, got end of input", nullptr));
     }
-
-private:
-    /**
-    * @brief Runes that cannot be used unescaped in quoteless strings.
-    **/
-    const std::set<std::string>& reserved_runes() { return options.supports_version(jsonh_version::v2) ? reserved_runes_v2 : reserved_runes_v1; }
-    /**
-    * @brief Runes that cannot be used unescaped in quoteless strings in JSONH V1.
-    **/
-    const std::set<std::string> reserved_runes_v1 = { "\\", ",", ":", "[", "]", "{", "}", "/", "#", "\"", "'" };
-    /**
-    * @brief Runes that cannot be used unescaped in quoteless strings in JSONH V2.
-    **/
-    const std::set<std::string> reserved_runes_v2 = { "\\", ",", ":", "[", "]", "{", "}", "/", "#", "\"", "'", "@" };
-    /**
-    * @brief Runes that are considered newlines.
-    **/
-    const std::set<std::string> newline_runes = { "\n", "\r", "\u2028", "\u2029" };
-    /**
-    * @brief Runes that are considered whitespace.
-    **/
-    const std::set<std::string> whitespace_runes = {
-        "\u0020", "\u00A0", "\u1680", "\u2000", "\u2001", "\u2002", "\u2003", "\u2004", "\u2005",
-        "\u2006", "\u2007", "\u2008", "\u2009", "\u200A", "\u202F", "\u205F", "\u3000", "\u2028",
-        "\u2029", "\u0009", "\u000A", "\u000B", "\u000C", "\u000D", "\u0085",
-    };
-
     std::generator<nonstd::expected<jsonh_token, std::string>> read_object() noexcept {
         // Opening brace
+        size_t start_position = position();
         if (!read_one("{")) {
             // Braceless object
-            for (const nonstd::expected<jsonh_token, std::string>& token : read_braceless_object()) {
+            for (nonstd::expected<jsonh_token, std::string>&& token : read_braceless_object()) {
                 if (!token) {
-                    co_yield(token);
+                    co_yield(std::move(token));
                     co_return;
                 }
-                co_yield(token);
+                co_yield(std::move(token));
             }
             co_return;
         }
         // Start of object
-        co_yield(jsonh_token(json_token_type::start_object));
+        co_yield(jsonh_token(json_token_type::start_object, "", start_position, 1));
         depth++;
 
         // Check exceeded max depth
@@ -620,15 +3675,16 @@ private:
             co_yield(nonstd::unexpected<std::string>("Exceeded max depth"));
             co_return;
         }
+        start_property_names();
 
         while (true) {
             // Comments & whitespace
-            for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+            for (nonstd::expected<jsonh_token, std::string>&& token : read_comments_and_whitespace()) {
                 if (!token) {
-                    co_yield(token);
+                    co_yield(std::move(token));
                     co_return;
                 }
-                co_yield(token);
+                co_yield(std::move(token));
             }
 
             std::optional<std::string> next = peek();
@@ -636,37 +3692,50 @@ private:
                 // End of incomplete object
                 if (options.incomplete_inputs) {
                     depth--;
-                    co_yield(jsonh_token(json_token_type::end_object));
+                    co_yield(jsonh_token(json_token_type::end_object, "", position()));
                     co_return;
                 }
                 // Missing closing brace
-                co_yield(nonstd::unexpected<std::string>("Expected `}` to end object, got end of input"));
+                std::string error = "Expected `}` to end object, got end of input";
+                if (add_diagnostic(error)) {
+                    depth--;
+                    co_yield(jsonh_token(json_token_type::end_object, "", position()));
+                    co_return;
+                }
+                co_yield(nonstd::unexpected<std::string>(std::move(error)));
                 co_return;
             }
 
             // Closing brace
             if (next.value() == "}") {
                 // End of object
+                size_t end_position = position();
                 read();
                 depth--;
-                co_yield(jsonh_token(json_token_type::end_object));
+                co_yield(jsonh_token(json_token_type::end_object, "", end_position, 1));
                 co_return;
             }
             // Property
             else {
-                for (const nonstd::expected<jsonh_token, std::string>& token : read_property()) {
+                int32_t property_depth = depth;
+                for (nonstd::expected<jsonh_token, std::string>&& token : read_property()) {
                     if (!token) {
-                        co_yield(token);
+                        // Recover from invalid property
+                        if (recover_from_error(token.error(), property_depth, '}')) {
+                            break;
+                        }
+                        co_yield(std::move(token));
                         co_return;
                     }
-                    co_yield(token);
+                    co_yield(std::move(token));
                 }
             }
         }
     }
     std::generator<nonstd::expected<jsonh_token, std::string>> read_braceless_object(std::optional<std::vector<jsonh_token>> property_name_tokens = std::nullopt) noexcept {
-        // Start of object
-        co_yield(jsonh_token(json_token_type::start_object));
+        // Start of object (at first property name)
+        size_t start_position = property_name_tokens ? property_name_tokens.value().back().position : position();
+        co_yield(jsonh_token(json_token_type::start_object, "", start_position));
         depth++;
 
         // Check exceeded max depth
@@ -674,57 +3743,68 @@ private:
             co_yield(nonstd::unexpected<std::string>("Exceeded max depth"));
             co_return;
         }
+        start_property_names();
 
         // Initial tokens
         if (property_name_tokens) {
-            for (const nonstd::expected<jsonh_token, std::string>& token : read_property(property_name_tokens)) {
+            int32_t property_depth = depth;
+            for (nonstd::expected<jsonh_token, std::string>&& token : read_property(std::move(property_name_tokens))) {
                 if (!token) {
-                    co_yield(token);
+                    // Recover from invalid property
+                    if (recover_from_error(token.error(), property_depth, '\0')) {
+                        break;
+                    }
+                    co_yield(std::move(token));
                     co_return;
                 }
-                co_yield(token);
+                co_yield(std::move(token));
             }
         }
 
         while (true) {
             // Comments & whitespace
-            for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+            for (nonstd::expected<jsonh_token, std::string>&& token : read_comments_and_whitespace()) {
                 if (!token) {
-                    co_yield(token);
+                    co_yield(std::move(token));
                     co_return;
                 }
-                co_yield(token);
+                co_yield(std::move(token));
             }
 
             if (!peek()) {
                 // End of braceless object
                 depth--;
-                co_yield(jsonh_token(json_token_type::end_object));
+                co_yield(jsonh_token(json_token_type::end_object, "", position()));
                 co_return;
             }
 
             // Property
-            for (const nonstd::expected<jsonh_token, std::string>& token : read_property()) {
+            int32_t property_depth = depth;
+            for (nonstd::expected<jsonh_token, std::string>&& token : read_property()) {
                 if (!token) {
-                    co_yield(token);
+                    // Recover from invalid property
+                    if (recover_from_error(token.error(), property_depth, '\0')) {
+                        break;
+                    }
+                    co_yield(std::move(token));
                     co_return;
                 }
-                co_yield(token);
+                co_yield(std::move(token));
             }
         }
     }
     std::generator<nonstd::expected<jsonh_token, std::string>> read_braceless_object_or_end_of_primitive(const jsonh_token& primitive_token) {
         // Comments & whitespace
         std::optional<std::vector<jsonh_token>> property_name_tokens = {};
-        for (const nonstd::expected<jsonh_token, std::string>& comment_or_whitespace_token : read_comments_and_whitespace()) {
+        for (nonstd::expected<jsonh_token, std::string>&& comment_or_whitespace_token : read_comments_and_whitespace()) {
             if (!comment_or_whitespace_token) {
-                co_yield(comment_or_whitespace_token);
+                co_yield(std::move(comment_or_whitespace_token));
                 co_return;
             }
             if (!property_name_tokens) {
                 property_name_tokens = std::vector<jsonh_token>();
             }
-            property_name_tokens.value().push_back(comment_or_whitespace_token.value());
+            property_name_tokens.value().push_back(std::move(comment_or_whitespace_token.value()));
         }
 
         // Primitive
@@ -733,8 +3813,8 @@ private:
             co_yield(primitive_token);
             // Comments & whitespace
             if (property_name_tokens) {
-                for (const jsonh_token& comment_or_whitespace_token : property_name_tokens.value()) {
-                    co_yield(comment_or_whitespace_token);
+                for (jsonh_token& comment_or_whitespace_token : property_name_tokens.value()) {
+                    co_yield(std::move(comment_or_whitespace_token));
                 }
             }
             // End of primitive
@@ -745,59 +3825,69 @@ private:
         if (!property_name_tokens) {
             property_name_tokens = std::vector<jsonh_token>();
         }
-        property_name_tokens.value().push_back(jsonh_token(json_token_type::property_name, primitive_token.value));
+        property_name_tokens.value().push_back(jsonh_token(json_token_type::property_name, primitive_token.value, primitive_token.position, primitive_token.length));
 
         // Braceless object
-        for (const nonstd::expected<jsonh_token, std::string>& object_token : read_braceless_object(property_name_tokens)) {
+        for (nonstd::expected<jsonh_token, std::string>&& object_token : read_braceless_object(std::move(property_name_tokens))) {
             if (!object_token) {
-                co_yield(object_token);
+                co_yield(std::move(object_token));
                 co_return;
             }
-            co_yield(object_token);
+            co_yield(std::move(object_token));
         }
     }
     std::generator<nonstd::expected<jsonh_token, std::string>> read_property(std::optional<std::vector<jsonh_token>> property_name_tokens = std::nullopt) noexcept {
         // Property name
         if (property_name_tokens) {
-            for (const jsonh_token& token : property_name_tokens.value()) {
-                co_yield(token);
+            for (jsonh_token& token : property_name_tokens.value()) {
+                // Duplicate property name
+                if (token.json_type == json_token_type::property_name && !add_property_name(token.value)) {
+                    co_yield(nonstd::unexpected<std::string>("Duplicate property name"));
+                    co_return;
+                }
+                co_yield(std::move(token));
             }
         }
         else {
-            for (const nonstd::expected<jsonh_token, std::string>& token : read_property_name()) {
+            for (nonstd::expected<jsonh_token, std::string>&& token : read_property_name()) {
                 if (!token) {
-                    co_yield(token);
+                    co_yield(std::move(token));
+                    co_return;
+                }
+                // Duplicate property name
+                if (token.value().json_type == json_token_type::property_name && !add_property_name(token.value().value)) {
+                    co_yield(nonstd::unexpected<std::string>("Duplicate property name"));
                     co_return;
                 }
-                co_yield(token);
+                co_yield(std::move(token));
             }
         }
 
         // Comments & whitespace
-        for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+        for (nonstd::expected<jsonh_token, std::string>&& token : read_comments_and_whitespace()) {
             if (!token) {
-                co_yield(token);
+                co_yield(std::move(token));
                 co_return;
             }
-            co_yield(token);
+            co_yield(std::move(token));
         }
 
         // Property value
-        for (const nonstd::expected<jsonh_token, std::string>& token : read_element()) {
+        for (nonstd::expected<jsonh_token, std::string>&& token : read_element()) {
             if (!token) {
-                co_yield(token);
+                co_yield(std::move(token));
                 co_return;
             }
-            co_yield(token);
+            co_yield(std::move(token));
         }
 
         // Comments & whitespace
-        for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+        for (nonstd::expected<jsonh_token, std::string>&& token : read_comments_and_whitespace()) {
             if (!token) {
-                co_yield(token);
+                co_yield(std::move(token));
                 co_return;
             }
-            co_yield(token);
+            co_yield(std::move(token));
         }
 
         // Optional comma
@@ -807,18 +3897,18 @@ private:
         // String
         nonstd::expected<jsonh_token, std::string> string_result = read_string();
         if (!string_result) {
-            co_yield(string_result);
+            co_yield(std::move(string_result));
             co_return;
         }
-        jsonh_token string = string_result.value();
+        jsonh_token string = std::move(string_result.value());
 
         // Comments & whitespace
-        for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+        for (nonstd::expected<jsonh_token, std::string>&& token : read_comments_and_whitespace()) {
             if (!token) {
-                co_yield(token);
+                co_yield(std::move(token));
                 co_return;
             }
-            co_yield(token);
+            co_yield(std::move(token));
         }
 
         // Colon
@@ -828,16 +3918,17 @@ private:
         }
 
         // End of property name
-        co_yield(jsonh_token(json_token_type::property_name, string.value));
+        co_yield(jsonh_token(json_token_type::property_name, std::move(string.value), string.position, string.length));
     }
     std::generator<nonstd::expected<jsonh_token, std::string>> read_array() noexcept {
         // Opening bracket
+        size_t start_position = position();
         if (!read_one("[")) {
             co_yield(nonstd::unexpected<std::string>("Expected `[` to start array"));
             co_return;
         }
         // Start of array
-        co_yield(jsonh_token(json_token_type::start_array));
+        co_yield(jsonh_token(json_token_type::start_array, "", start_position, 1));
         depth++;
 
         // Check exceeded max depth
@@ -848,12 +3939,12 @@ private:
 
         while (true) {
             // Comments & whitespace
-            for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+            for (nonstd::expected<jsonh_token, std::string>&& token : read_comments_and_whitespace()) {
                 if (!token) {
-                    co_yield(token);
+                    co_yield(std::move(token));
                     co_return;
                 }
-                co_yield(token);
+                co_yield(std::move(token));
             }
 
             std::optional<std::string> next = peek();
@@ -861,57 +3952,71 @@ private:
                 // End of incomplete array
                 if (options.incomplete_inputs) {
                     depth--;
-                    co_yield(jsonh_token(json_token_type::end_array));
+                    co_yield(jsonh_token(json_token_type::end_array, "", position()));
                     co_return;
                 }
                 // Missing closing bracket
-                co_yield(nonstd::unexpected<std::string>("Expected `]` to end array, got end of input"));
+                std::string error = "Expected `]` to end array, got end of input";
+                if (add_diagnostic(error)) {
+                    depth--;
+                    co_yield(jsonh_token(json_token_type::end_array, "", position()));
+                    co_return;
+                }
+                co_yield(nonstd::unexpected<std::string>(std::move(error)));
                 co_return;
             }
 
             // Closing bracket
             if (next.value() == "]") {
                 // End of array
+                size_t end_position = position();
                 read();
                 depth--;
-                co_yield(jsonh_token(json_token_type::end_array));
+                co_yield(jsonh_token(json_token_type::end_array, "", end_position, 1));
                 co_return;
             }
             // Item
             else {
-                for (const nonstd::expected<jsonh_token, std::string>& token : read_item()) {
+                int32_t item_depth = depth;
+                for (nonstd::expected<jsonh_token, std::string>&& token : read_item()) {
                     if (!token) {
-                        co_yield(token);
+                        // Recover from invalid item
+                        if (recover_from_error(token.error(), item_depth, ']')) {
+                            break;
+                        }
+                        co_yield(std::move(token));
                         co_return;
                     }
-                    co_yield(token);
+                    co_yield(std::move(token));
                 }
             }
         }
     }
     std::generator<nonstd::expected<jsonh_token, std::string>> read_item() noexcept {
         // Element
-        for (const nonstd::expected<jsonh_token, std::string>& token : read_element()) {
+        for (nonstd::expected<jsonh_token, std::string>&& token : read_element()) {
             if (!token) {
-                co_yield(token);
+                co_yield(std::move(token));
                 co_return;
             }
-            co_yield(token);
+            co_yield(std::move(token));
         }
 
         // Comments & whitespace
-        for (const nonstd::expected<jsonh_token, std::string>& token : read_comments_and_whitespace()) {
+        for (nonstd::expected<jsonh_token, std::string>&& token : read_comments_and_whitespace()) {
             if (!token) {
-                co_yield(token);
+                co_yield(std::move(token));
                 co_return;
             }
-            co_yield(token);
+            co_yield(std::move(token));
         }
 
         // Optional comma
         read_one(",");
     }
     nonstd::expected<jsonh_token, std::string> read_string() noexcept {
+        size_t start_position = position();
+
         // Verbatim
         bool is_verbatim = false;
         if (options.supports_version(jsonh_version::v2) && read_one("@")) {
@@ -927,7 +4032,7 @@ private:
         // Start quote
         std::optional<std::string> start_quote = read_any({ "\"", "'" });
         if (!start_quote) {
-            return read_quoteless_string("", is_verbatim);
+            return read_quoteless_string("", is_verbatim, start_position);
         }
         char start_quote_char = start_quote.value()[0];
 
@@ -939,7 +4044,17 @@ private:
 
         // Empty string
         if (start_quote_counter == 2) {
-            return jsonh_token(json_token_type::string, "");
+            return jsonh_token(json_token_type::string, "", start_position, position() - start_position);
+        }
+
+        // Single quote performance optimisation (the common case in JSON)
+        if (start_quote_counter == 1) {
+            std::string string_builder;
+            nonstd::expected<void, std::string> string_result = read_single_quoted_string(start_quote_char, is_verbatim, string_builder);
+            if (!string_result) {
+                return nonstd::unexpected<std::string>(string_result.error());
+            }
+            return jsonh_token(json_token_type::string, std::move(string_builder), start_position, position() - start_position);
         }
 
         // Count multiple end quotes
@@ -973,11 +4088,10 @@ private:
                     string_builder += next.value();
                 }
                 else {
-                    nonstd::expected<std::string, std::string> escape_sequence_result = read_escape_sequence();
+                    nonstd::expected<void, std::string> escape_sequence_result = read_escape_sequence(string_builder);
                     if (!escape_sequence_result) {
                         return nonstd::unexpected<std::string>(escape_sequence_result.error());
                     }
-                    string_builder += escape_sequence_result.value();
                 }
             }
             // Literal character
@@ -1104,20 +4218,76 @@ private:
                     }
                 }
             }
-
-            // Get string builder from chars
-            string_builder.clear();
-            for (const std::string& c : string_builder_chars) {
-                string_builder += c;
-            }
+
+            // Get string builder from chars
+            string_builder.clear();
+            for (const std::string& c : string_builder_chars) {
+                string_builder += c;
+            }
+        }
+
+        // End of string
+        return jsonh_token(json_token_type::string, std::move(string_builder), start_position, position() - start_position);
+    }
+    nonstd::expected<void, std::string> read_single_quoted_string(char start_quote_char, bool is_verbatim, std::string& string_builder) noexcept {
+        // Scan bytes directly since the quote and backslash are ASCII
+        std::streambuf* buffer = inner_stream->rdbuf();
+        const int end_of_buffer = std::char_traits<char>::eof();
+
+        while (true) {
+            // Read byte
+            int next = buffer->sbumpc();
+            if (next == end_of_buffer) {
+                return nonstd::unexpected<std::string>("Expected end of string, got end of input");
+            }
+
+            // End quote
+            if (next == start_quote_char) {
+                break;
+            }
+            // Escape sequence
+            else if (next == '\\') {
+                if (is_verbatim) {
+                    string_builder.push_back('\\');
+                }
+                else {
+                    nonstd::expected<void, std::string> escape_sequence_result = read_escape_sequence(string_builder);
+                    if (!escape_sequence_result) {
+                        return nonstd::unexpected<std::string>(escape_sequence_result.error());
+                    }
+                }
+            }
+            // Literal character
+            else {
+                string_builder.push_back((char)next);
+
+                // Keep multi-byte runes together (as in read)
+                if (next > 127) {
+                    for (uint8_t index = 1; index < get_utf8_sequence_length((std::uint8_t)next); index++) {
+                        int continuation = buffer->sbumpc();
+                        if (continuation == end_of_buffer) {
+                            break;
+                        }
+                        string_builder.push_back((char)continuation);
+                    }
+                }
+            }
         }
 
         // End of string
-        return jsonh_token(json_token_type::string, string_builder);
+        inner_stream->clear();
+        return nonstd::expected<void, std::string>(); // Success
     }
-    nonstd::expected<jsonh_token, std::string> read_quoteless_string(const std::string& initial_chars = "", bool is_verbatim = false) noexcept {
+    nonstd::expected<jsonh_token, std::string> read_quoteless_string(const std::string& initial_chars = "", bool is_verbatim = false, std::optional<size_t> start_position = std::nullopt) noexcept {
         bool is_named_literal_possible = !is_verbatim;
 
+        // Get position of first char
+        if (!start_position) {
+            start_position = position();
+        }
+        // Get position after last non-whitespace char
+        std::optional<size_t> trailing_whitespace_position;
+
         // Read quoteless string
         std::string string_builder = initial_chars;
 
@@ -1135,13 +4305,13 @@ private:
                     string_builder += next.value();
                 }
                 else {
-                    nonstd::expected<std::string, std::string> escape_sequence_result = read_escape_sequence();
+                    nonstd::expected<void, std::string> escape_sequence_result = read_escape_sequence(string_builder);
                     if (!escape_sequence_result) {
                         return nonstd::unexpected<std::string>(escape_sequence_result.error());
                     }
-                    string_builder += escape_sequence_result.value();
                 }
                 is_named_literal_possible = false;
+                trailing_whitespace_position.reset();
             }
             // End on reserved character
             else if (reserved_runes().contains(next.value())) {
@@ -1153,6 +4323,16 @@ private:
             }
             // Literal character
             else {
+                // Track trailing whitespace
+                if (whitespace_runes.contains(next.value())) {
+                    if (!trailing_whitespace_position) {
+                        trailing_whitespace_position = position();
+                    }
+                }
+                else {
+                    trailing_whitespace_position.reset();
+                }
+
                 read();
                 string_builder += next.value();
             }
@@ -1189,21 +4369,25 @@ private:
             }
         }
 
+        // Get length excluding trailing whitespace
+        size_t end_position = trailing_whitespace_position ? trailing_whitespace_position.value() : position();
+        size_t length = end_position - start_position.value();
+
         // Match named literal
         if (is_named_literal_possible) {
             if (string_builder == "null") {
-                return jsonh_token(json_token_type::null, "null");
+                return jsonh_token(json_token_type::null, "null", start_position.value(), length);
             }
             else if (string_builder == "true") {
-                return jsonh_token(json_token_type::true_bool, "true");
+                return jsonh_token(json_token_type::true_bool, "true", start_position.value(), length);
             }
             else if (string_builder == "false") {
-                return jsonh_token(json_token_type::false_bool, "false");
+                return jsonh_token(json_token_type::false_bool, "false", start_position.value(), length);
             }
         }
 
         // End quoteless string
-        return jsonh_token(json_token_type::string, string_builder);
+        return jsonh_token(json_token_type::string, std::move(string_builder), start_position.value(), length);
     }
     bool detect_quoteless_string(std::string& whitespace_builder) {
         while (true) {
@@ -1234,6 +4418,8 @@ private:
         return next_char && (next_char.value() == "\\" || !reserved_runes().contains(next_char.value()));
     }
     nonstd::expected<jsonh_token, std::string> read_number(std::string& number_builder) noexcept {
+        size_t start_position = position();
+
         // Read sign
         std::optional<std::string> sign = read_any({ "-", "+" });
         if (sign) {
@@ -1321,7 +4507,7 @@ private:
         }
 
         // End of number
-        return jsonh_token(json_token_type::number, number_builder);
+        return jsonh_token(json_token_type::number, number_builder, start_position, position() - start_position);
     }
     nonstd::expected<void, std::string> read_number_no_exponent(std::string& number_builder, std::string_view base_digits, bool has_base_specifier = false, bool has_leading_zero = false) noexcept {
         // Leading underscore
@@ -1403,6 +4589,16 @@ private:
         return nonstd::expected<void, std::string>(); // Success
     }
     nonstd::expected<jsonh_token, std::string> read_number_or_quoteless_string() noexcept {
+        size_t start_position = position();
+
+        // JSON number performance optimisation
+        std::string json_number_builder;
+        if (read_json_number(json_number_builder) && read_end_of_json_number()) {
+            size_t length = json_number_builder.size();
+            return jsonh_token(json_token_type::number, std::move(json_number_builder), start_position, length);
+        }
+        seek(start_position);
+
         // Read number
         std::string number_builder;
         nonstd::expected<jsonh_token, std::string> number = read_number(number_builder);
@@ -1410,7 +4606,7 @@ private:
             // Try read quoteless string starting with number
             std::string whitespace_chars;
             if (detect_quoteless_string(whitespace_chars)) {
-                return read_quoteless_string(number.value().value + whitespace_chars);
+                return read_quoteless_string(number.value().value + whitespace_chars, false, start_position);
             }
             // Otherwise, accept number
             else {
@@ -1419,7 +4615,72 @@ private:
         }
         // Read quoteless string starting with malformed number
         else {
-            return read_quoteless_string(number_builder);
+            return read_quoteless_string(number_builder, false, start_position);
+        }
+    }
+    bool read_json_number(std::string& number_builder) noexcept {
+        // Scan bytes directly since JSON numbers are ASCII
+        std::streambuf* buffer = inner_stream->rdbuf();
+
+        auto read_digits = [&]() -> bool {
+            size_t original_size = number_builder.size();
+            while (buffer->sgetc() >= '0' && buffer->sgetc() <= '9') {
+                number_builder.push_back((char)buffer->sbumpc());
+            }
+            return number_builder.size() > original_size;
+        };
+
+        // Sign
+        if (buffer->sgetc() == '-') {
+            number_builder.push_back((char)buffer->sbumpc());
+        }
+        // Integer (no leading zeros)
+        bool is_valid = true;
+        if (buffer->sgetc() == '0') {
+            number_builder.push_back((char)buffer->sbumpc());
+        }
+        else {
+            is_valid = read_digits();
+        }
+        // Fraction
+        if (is_valid && buffer->sgetc() == '.') {
+            number_builder.push_back((char)buffer->sbumpc());
+            is_valid = read_digits();
+        }
+        // Exponent
+        if (is_valid && (buffer->sgetc() == 'e' || buffer->sgetc() == 'E')) {
+            number_builder.push_back((char)buffer->sbumpc());
+            if (buffer->sgetc() == '-' || buffer->sgetc() == '+') {
+                number_builder.push_back((char)buffer->sbumpc());
+            }
+            is_valid = read_digits();
+        }
+        return is_valid;
+    }
+    bool read_end_of_json_number() noexcept {
+        std::streambuf* buffer = inner_stream->rdbuf();
+
+        // Whitespace (a quoteless string may follow)
+        int next = buffer->sgetc();
+        while (next == ' ' || next == '\t') {
+            buffer->sbumpc();
+            next = buffer->sgetc();
+        }
+        inner_stream->clear();
+
+        // End on reserved character (except backslash), newline or end of input
+        switch (next) {
+            case std::char_traits<char>::eof():
+            case ',': case ':': case '[': case ']': case '{': case '}': case '/': case '#': case '"': case '\'':
+            case '\n': case '\r': {
+                return true;
+            }
+            case '@': {
+                return options.supports_version(jsonh_version::v2);
+            }
+            default: {
+                return false;
+            }
         }
     }
     nonstd::expected<jsonh_token, std::string> read_primitive_element() noexcept {
@@ -1455,12 +4716,23 @@ private:
 
             // Comment
             if (next.value() == "#" || next.value() == "/") {
-                nonstd::expected<jsonh_token, std::string> comment = read_comment();
-                if (!comment) {
-                    co_yield(comment);
-                    co_return;
+                // Skip comment
+                if (options.skip_comments || is_skipping_comments) {
+                    nonstd::expected<void, std::string> skip_result = skip_comment();
+                    if (!skip_result) {
+                        co_yield(nonstd::unexpected<std::string>(skip_result.error()));
+                        co_return;
+                    }
+                }
+                // Read comment
+                else {
+                    nonstd::expected<jsonh_token, std::string> comment = read_comment();
+                    if (!comment) {
+                        co_yield(std::move(comment));
+                        co_return;
+                    }
+                    co_yield(std::move(comment));
                 }
-                co_yield(comment);
             }
             // End of comments
             else {
@@ -1469,36 +4741,15 @@ private:
         }
     }
     nonstd::expected<jsonh_token, std::string> read_comment() noexcept {
+        size_t start_position = position();
+
         bool block_comment = false;
         int32_t start_nest_counter = 0;
 
-        // Hash-style comment
-        if (read_one("#")) {
-        }
-        else if (read_one("/")) {
-            // Line-style comment
-            if (read_one("/")) {
-            }
-            // Block-style comment
-            else if (read_one("*")) {
-                block_comment = true;
-            }
-            // Nestable block-style comment
-            else if (options.supports_version(jsonh_version::v2) && peek() == "=") {
-                block_comment = true;
-                while (read_one("=")) {
-                    start_nest_counter++;
-                }
-                if (!read_one("*")) {
-                    return nonstd::unexpected<std::string>("Expected `*` after start of nesting block comment");
-                }
-            }
-            else {
-                return nonstd::unexpected<std::string>("Unexpected `/`");
-            }
-        }
-        else {
-            return nonstd::unexpected<std::string>("Unexpected character");
+        // Start of comment
+        nonstd::expected<void, std::string> start_result = read_start_of_comment(block_comment, start_nest_counter);
+        if (!start_result) {
+            return nonstd::unexpected<std::string>(start_result.error());
         }
 
         // Read comment
@@ -1535,14 +4786,16 @@ private:
 
                     // End of block comment
                     if (read_one("/")) {
-                        return jsonh_token(json_token_type::comment, comment_builder);
+                        return jsonh_token(json_token_type::comment, comment_builder, start_position, position() - start_position);
                     }
                 }
             }
             else {
                 // End of line comment
                 if (!next || newline_runes.contains(next.value())) {
-                    return jsonh_token(json_token_type::comment, comment_builder);
+                    // Exclude newline from comment
+                    size_t end_position = position() - (next ? next.value().size() : 0);
+                    return jsonh_token(json_token_type::comment, comment_builder, start_position, end_position - start_position);
                 }
             }
 
@@ -1550,8 +4803,125 @@ private:
             comment_builder += next.value();
         }
     }
+    nonstd::expected<void, std::string> skip_comment() noexcept {
+        bool block_comment = false;
+        int32_t start_nest_counter = 0;
+
+        // Start of comment
+        nonstd::expected<void, std::string> start_result = read_start_of_comment(block_comment, start_nest_counter);
+        if (!start_result) {
+            return start_result;
+        }
+
+        // Scan bytes directly since all delimiters are ASCII
+        std::streambuf* buffer = inner_stream->rdbuf();
+        const int end_of_buffer = std::char_traits<char>::eof();
+
+        // Block comment
+        if (block_comment) {
+            while (true) {
+                // Read byte
+                int next = buffer->sbumpc();
+                if (next == end_of_buffer) {
+                    return nonstd::unexpected<std::string>("Expected end of block comment, got end of input");
+                }
+
+                // End of block comment
+                if (next == '*') {
+                    // End of nestable block comment
+                    if (options.supports_version(jsonh_version::v2)) {
+                        // Count nests
+                        int32_t end_nest_counter = 0;
+                        while (end_nest_counter < start_nest_counter && buffer->sgetc() == '=') {
+                            buffer->sbumpc();
+                            end_nest_counter++;
+                        }
+                        // Partial end nestable block comment was actually part of comment
+                        if (end_nest_counter < start_nest_counter) {
+                            continue;
+                        }
+                    }
+
+                    // End of block comment
+                    if (buffer->sgetc() == '/') {
+                        buffer->sbumpc();
+                        return nonstd::expected<void, std::string>(); // Success
+                    }
+                }
+            }
+        }
+        // Line comment
+        else {
+            while (true) {
+                // Read byte
+                int next = buffer->sbumpc();
+                if (next == end_of_buffer) {
+                    return nonstd::expected<void, std::string>(); // Success
+                }
+
+                // End of line comment (\n, \r)
+                if (next == '\n' || next == '\r') {
+                    return nonstd::expected<void, std::string>(); // Success
+                }
+                // End of line comment (\u2028, \u2029)
+                if (next == 0xE2) {
+                    int second = buffer->sbumpc();
+                    int third = buffer->sbumpc();
+                    if (second == 0x80 && (third == 0xA8 || third == 0xA9)) {
+                        return nonstd::expected<void, std::string>(); // Success
+                    }
+                    if (third == end_of_buffer) {
+                        return nonstd::expected<void, std::string>(); // Success
+                    }
+                }
+            }
+        }
+    }
+    nonstd::expected<void, std::string> read_start_of_comment(bool& block_comment, int32_t& start_nest_counter) noexcept {
+        // Hash-style comment
+        if (read_one("#")) {
+        }
+        else if (read_one("/")) {
+            // Line-style comment
+            if (read_one("/")) {
+            }
+            // Block-style comment
+            else if (read_one("*")) {
+                block_comment = true;
+            }
+            // Nestable block-style comment
+            else if (options.supports_version(jsonh_version::v2) && peek() == "=") {
+                block_comment = true;
+                while (read_one("=")) {
+                    start_nest_counter++;
+                }
+                if (!read_one("*")) {
+                    return nonstd::unexpected<std::string>("Expected `*` after start of nesting block comment");
+                }
+            }
+            else {
+                return nonstd::unexpected<std::string>("Unexpected `/`");
+            }
+        }
+        else {
+            return nonstd::unexpected<std::string>("Unexpected character");
+        }
+        return nonstd::expected<void, std::string>(); // Success
+    }
     void read_whitespace() noexcept {
+        std::streambuf* buffer = inner_stream->rdbuf();
+
         while (true) {
+            // ASCII whitespace performance optimisation
+            int next_byte = buffer->sgetc();
+            if (next_byte == ' ' || (next_byte >= '\t' && next_byte <= '\r')) {
+                buffer->sbumpc();
+                continue;
+            }
+            if (next_byte >= 0 && next_byte <= 127) {
+                return;
+            }
+
             // Peek rune
             std::optional<std::string> next = peek();
             if (!next) {
@@ -1572,173 +4942,231 @@ private:
     nonstd::expected<uint32_t, std::string> read_hex_sequence() noexcept {
         static_assert(LENGTH <= 8);
 
+        std::streambuf* buffer = inner_stream->rdbuf();
         uint32_t value = 0;
 
         for (size_t index = 0; index < LENGTH; index++) {
-            std::optional<std::string> next = read();
+            // Convert hex digit to integer
+            int next = buffer->sbumpc();
+            int8_t integer = next < 0 ? -1 : hex_digit_values[(uint8_t)next];
 
-            // Hex digit
-            if (next && ((next >= "0" && next <= "9") || (next >= "A" && next <= "F") || (next >= "a" && next <= "f"))) {
-                // Get hex digit
-                char digit = next.value()[0];
-                // Convert hex digit to integer
-                uint32_t integer =
-                    (digit >= 'A' && digit <= 'F') ? digit - 'A' + 10 :
-                    (digit >= 'a' && digit <= 'f') ? digit - 'a' + 10 :
-                    digit - '0';
-                // Aggregate digit into value
-                value = (value * 16) + integer;
-            }
             // Unexpected char
-            else {
+            if (integer < 0) {
                 return nonstd::unexpected<std::string>("Incorrect number of hexadecimal digits in unicode escape sequence");
             }
+
+            // Aggregate digit into value
+            value = (value * 16) + (uint32_t)integer;
         }
 
         // Return aggregated value
         return value;
     }
-    nonstd::expected<std::string, std::string> read_escape_sequence(std::optional<uint32_t> high_surrogate = std::nullopt) noexcept {
-        std::optional<std::string> escape_char = read();
-        if (!escape_char) {
+    nonstd::expected<void, std::string> read_escape_sequence(std::string& string_builder) noexcept {
+        std::streambuf* buffer = inner_stream->rdbuf();
+
+        int escape_char = buffer->sbumpc();
+        if (escape_char < 0) {
             return nonstd::unexpected<std::string>("Expected escape sequence, got end of input");
         }
 
-        // Ensure high surrogates are completed
-        if (high_surrogate && escape_char.value() != "u" && escape_char.value() != "x" && escape_char.value() != "U") {
-            return nonstd::unexpected<std::string>("Expected low surrogate after high surrogate");
-        }
+        switch (escape_char) {
+            // Reverse solidus
+            case '\\': {
+                string_builder.push_back('\\');
+                break;
+            }
+            // Backspace
+            case 'b': {
+                string_builder.push_back('\b');
+                break;
+            }
+            // Form feed
+            case 'f': {
+                string_builder.push_back('\f');
+                break;
+            }
+            // Newline
+            case 'n': {
+                string_builder.push_back('\n');
+                break;
+            }
+            // Carriage return
+            case 'r': {
+                string_builder.push_back('\r');
+                break;
+            }
+            // Tab
+            case 't': {
+                string_builder.push_back('\t');
+                break;
+            }
+            // Vertical tab
+            case 'v': {
+                string_builder.push_back('\v');
+                break;
+            }
+            // Null
+            case '0': {
+                string_builder.push_back('\0');
+                break;
+            }
+            // Alert
+            case 'a': {
+                string_builder.push_back('\a');
+                break;
+            }
+            // Escape
+            case 'e': {
+                string_builder.push_back('\x1b');
+                break;
+            }
+            // Unicode hex sequence
+            case 'u': {
+                // Decode a run of unicode hex sequences without returning to the caller
+                while (true) {
+                    nonstd::expected<void, std::string> result = read_hex_escape_sequence<4>(string_builder);
+                    if (!result) {
+                        return result;
+                    }
 
-        // Reverse solidus
-        if (escape_char.value() == "\\") {
-            return "\\";
-        }
-        // Backspace
-        else if (escape_char.value() == "b") {
-            return "\b";
-        }
-        // Form feed
-        else if (escape_char.value() == "f") {
-            return "\f";
-        }
-        // Newline
-        else if (escape_char.value() == "n") {
-            return "\n";
-        }
-        // Carriage return
-        else if (escape_char.value() == "r") {
-            return "\r";
-        }
-        // Tab
-        else if (escape_char.value() == "t") {
-            return "\t";
-        }
-        // Vertical tab
-        else if (escape_char.value() == "v") {
-            return "\v";
-        }
-        // Null
-        else if (escape_char.value() == "0") {
-            return "\0";
-        }
-        // Alert
-        else if (escape_char.value() == "a") {
-            return "\a";
-        }
-        // Escape
-        else if (escape_char.value() == "e") {
-            return "\u001b";
-        }
-        // Unicode hex sequence
-        else if (escape_char.value() == "u") {
-            return read_hex_escape_sequence<4>(high_surrogate);
-        }
-        // Short unicode hex sequence
-        else if (escape_char.value() == "x") {
-            return read_hex_escape_sequence<2>(high_surrogate);
-        }
-        // Long unicode hex sequence
-        else if (escape_char.value() == "U") {
-            return read_hex_escape_sequence<8>(high_surrogate);
-        }
-        // Escaped newline
-        else if (newline_runes.contains(escape_char.value())) {
-            // Join CR LF
-            if (escape_char == "\r") {
-                read_one("\n");
+                    // Next unicode hex sequence
+                    if (buffer->sgetc() != '\\') {
+                        break;
+                    }
+                    buffer->sbumpc();
+                    if (buffer->sgetc() != 'u') {
+                        buffer->sungetc();
+                        break;
+                    }
+                    buffer->sbumpc();
+                }
+                break;
+            }
+            // Short unicode hex sequence
+            case 'x': {
+                return read_hex_escape_sequence<2>(string_builder);
+            }
+            // Long unicode hex sequence
+            case 'U': {
+                return read_hex_escape_sequence<8>(string_builder);
+            }
+            // Escaped newline (\n)
+            case '\n': {
+                break;
+            }
+            // Escaped newline (\r)
+            case '\r': {
+                // Join CR LF
+                if (buffer->sgetc() == '\n') {
+                    buffer->sbumpc();
+                }
+                break;
+            }
+            // Other
+            default: {
+                // Single byte character
+                if (escape_char <= 127) {
+                    string_builder.push_back((char)escape_char);
+                    break;
+                }
+
+                // Read whole rune
+                buffer->sungetc();
+                std::optional<std::string> escape_rune = read();
+
+                // Escaped newline (\u2028, \u2029)
+                if (newline_runes.contains(escape_rune.value())) {
+                    break;
+                }
+                string_builder.append(escape_rune.value());
+                break;
             }
-            return "";
-        }
-        // Other
-        else {
-            return escape_char.value();
         }
+        return nonstd::expected<void, std::string>(); // Success
     }
     template <size_t LENGTH>
-    nonstd::expected<std::string, std::string> read_hex_escape_sequence(std::optional<uint32_t> high_surrogate) noexcept {
+    nonstd::expected<void, std::string> read_hex_escape_sequence(std::string& string_builder) noexcept {
         nonstd::expected<uint32_t, std::string> code_point = read_hex_sequence<LENGTH>();
         if (!code_point) {
             return nonstd::unexpected<std::string>(code_point.error());
         }
 
-        // Low surrogate
-        if (high_surrogate) {
-            nonstd::expected<uint32_t, std::string> combined = utf16_surrogates_to_code_point(high_surrogate.value(), code_point.value());
-            if (!combined) {
-                return nonstd::unexpected<std::string>(combined.error());
-            }
-            return code_point_to_utf8(combined.value());
+        // Standalone character
+        if (!is_utf16_high_surrogate(code_point.value()) || !read_one("\\")) {
+            return code_point_to_utf8(code_point.value(), string_builder);
         }
-        else {
-            // High surrogate followed by low surrogate
-            if (is_utf16_high_surrogate(code_point.value()) && read_one("\\")) {
-                return read_escape_sequence(code_point.value());
+
+        // High surrogate followed by low surrogate (decoded in the same frame so long runs of surrogate pairs use constant stack)
+        std::streambuf* buffer = inner_stream->rdbuf();
+        int escape_char = buffer->sbumpc();
+        nonstd::expected<uint32_t, std::string> low_surrogate;
+        switch (escape_char) {
+            // Unicode hex sequence
+            case 'u': {
+                low_surrogate = read_hex_sequence<4>();
+                break;
             }
-            // Standalone character
-            else {
-                return code_point_to_utf8(code_point.value());
+            // Short unicode hex sequence
+            case 'x': {
+                low_surrogate = read_hex_sequence<2>();
+                break;
             }
+            // Long unicode hex sequence
+            case 'U': {
+                low_surrogate = read_hex_sequence<8>();
+                break;
+            }
+            // End of input
+            case std::char_traits<char>::eof(): {
+                return nonstd::unexpected<std::string>("Expected escape sequence, got end of input");
+            }
+            // Other
+            default: {
+                return nonstd::unexpected<std::string>("Expected low surrogate after high surrogate");
+            }
+        }
+        if (!low_surrogate) {
+            return nonstd::unexpected<std::string>(low_surrogate.error());
+        }
+        nonstd::expected<uint32_t, std::string> combined = utf16_surrogates_to_code_point(code_point.value(), low_surrogate.value());
+        if (!combined) {
+            return nonstd::unexpected<std::string>(combined.error());
         }
+        return code_point_to_utf8(combined.value(), string_builder);
     }
-    static nonstd::expected<std::string, std::string> code_point_to_utf8(uint32_t code_point) noexcept {
+    static nonstd::expected<void, std::string> code_point_to_utf8(uint32_t code_point, std::string& string_builder) noexcept {
         // Invalid surrogate
         if (code_point >= 0xD800 && code_point <= 0xDFFF) {
             return nonstd::unexpected<std::string>("Invalid code point (surrogate half)");
         }
         // 1-byte UTF-8
         else if (code_point <= 0x7F) {
-            return std::string({
-                (char)code_point,
-            });
+            string_builder.push_back((char)code_point);
         }
         // 2-byte UTF-8
         else if (code_point <= 0x7FF) {
-            return std::string({
-                (char)(0xC0 | (code_point >> 6)),
-                (char)(0x80 | (code_point & 0x3F)),
-            });
+            string_builder.push_back((char)(0xC0 | (code_point >> 6)));
+            string_builder.push_back((char)(0x80 | (code_point & 0x3F)));
         }
         // 3-byte UTF-8
         else if (code_point <= 0xFFFF) {
-            return std::string({
-                (char)(0xE0 | (code_point >> 12)),
-                (char)(0x80 | ((code_point >> 6) & 0x3F)),
-                (char)(0x80 | (code_point & 0x3F)),
-            });
+            string_builder.push_back((char)(0xE0 | (code_point >> 12)));
+            string_builder.push_back((char)(0x80 | ((code_point >> 6) & 0x3F)));
+            string_builder.push_back((char)(0x80 | (code_point & 0x3F)));
         }
         // 4-byte UTF-8
         else if (code_point <= 0x10FFFF) {
-            return std::string({
-                (char)(0xF0 | (code_point >> 18)),
-                (char)(0x80 | ((code_point >> 12) & 0x3F)),
-                (char)(0x80 | ((code_point >> 6) & 0x3F)),
-                (char)(0x80 | (code_point & 0x3F)),
-            });
+            string_builder.push_back((char)(0xF0 | (code_point >> 18)));
+            string_builder.push_back((char)(0x80 | ((code_point >> 12) & 0x3F)));
+            string_builder.push_back((char)(0x80 | ((code_point >> 6) & 0x3F)));
+            string_builder.push_back((char)(0x80 | (code_point & 0x3F)));
         }
         // Invalid UTF-8
         else {
             return nonstd::unexpected<std::string>("Invalid code point (out of range)");
         }
+        return nonstd::expected<void, std::string>(); // Success
     }
     static nonstd::expected<uint32_t, std::string> utf16_surrogates_to_code_point(uint32_t high_surrogate, uint32_t low_surrogate) noexcept {
         if (!is_utf16_high_surrogate(high_surrogate)) {
@@ -1755,6 +5183,64 @@ private:
     static constexpr bool is_utf16_low_surrogate(uint32_t code_point) noexcept {
         return code_point >= 0xDC00 && code_point <= 0xDFFF;
     }
+    static bool parse_integer_number(std::string_view jsonh_number, uint64_t& magnitude, bool& is_negative) noexcept {
+        // Remove underscores
+        std::string digits;
+        digits.reserve(jsonh_number.size());
+        for (char next : jsonh_number) {
+            if (next != '_') {
+                digits.push_back(next);
+            }
+        }
+        std::string_view digits_view = digits;
+
+        // Get sign
+        is_negative = digits_view.starts_with('-');
+        if (digits_view.starts_with('-') || digits_view.starts_with('+')) {
+            digits_view.remove_prefix(1);
+        }
+
+        // Get base
+        int base = 10;
+        if (digits_view.size() >= 2 && digits_view[0] == '0') {
+            switch (digits_view[1]) {
+                case 'x': case 'X': base = 16; break;
+                case 'b': case 'B': base = 2; break;
+                case 'o': case 'O': base = 8; break;
+                default: break;
+            }
+            if (base != 10) {
+                digits_view.remove_prefix(2);
+            }
+        }
+
+        // Parse digits (fails on overflow)
+        std::from_chars_result result = std::from_chars(digits_view.data(), digits_view.data() + digits_view.size(), magnitude, base);
+        return result.ec == std::errc() && result.ptr == digits_view.data() + digits_view.size();
+    }
+    static bool is_integer_number(std::string_view jsonh_number) noexcept {
+        // Fraction
+        if (jsonh_number.find('.') != std::string::npos) {
+            return false;
+        }
+
+        // Remove sign
+        if (jsonh_number.starts_with('-') || jsonh_number.starts_with('+')) {
+            jsonh_number = jsonh_number.substr(1);
+        }
+
+        // Hexadecimal exponent (`e` is a digit, so exponents need a sign)
+        if (jsonh_number.starts_with("0x") || jsonh_number.starts_with("0X")) {
+            for (size_t index = 0; index + 1 < jsonh_number.size(); index++) {
+                if ((jsonh_number[index] == 'e' || jsonh_number[index] == 'E') && (jsonh_number[index + 1] == '+' || jsonh_number[index + 1] == '-')) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        // Exponent
+        return jsonh_number.find_first_of("eE") == std::string::npos;
+    }
     static std::string to_ascii_lower(const char* string) noexcept {
         std::string result(string);
         for (char& next : result) {
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstddef>
 #include "jsonh_version.hpp"
+#include "jsonh_duplicate_property_policy.hpp"
 
 namespace jsonh_cpp {
 
@@ -52,6 +54,47 @@ struct jsonh_reader_options {
     * Only some tokens can be incomplete in this mode, so it should not be relied upon.
     **/
     bool incomplete_inputs = false;
+    /**
+    * @brief Enables/disables skipping comments without reading them into tokens.
+    *
+    * @code{.jsonh}
+    * // This comment is not read as a token
+    * [1, 2, 3]
+    * @endcode
+    *
+    * Comments are still checked for errors (such as an unclosed block comment).
+    * When parsing elements, comments are always skipped since they are not part of the result.
+    **/
+    bool skip_comments = false;
+    /**
+    * @brief Specifies how to handle objects containing multiple properties with the same name.
+    *
+    * @code{.jsonh}
+    * {
+    *   a: 1,
+    *   a: 2, // Error: Duplicate property name (with jsonh_duplicate_property_policy::error)
+    * }
+    * @endcode
+    *
+    * When reading tokens, only @ref jsonh_duplicate_property_policy::error applies.
+    * When parsing elements with a SAX handler, @ref jsonh_duplicate_property_policy::collect does not apply.
+    **/
+    jsonh_duplicate_property_policy duplicate_property_policy = jsonh_duplicate_property_policy::last_wins;
+    /**
+    * @brief Sets the maximum number of errors to recover from when parsing with diagnostics.
+    *
+    * @code{.jsonh}
+    * {
+    *   a: 1,
+    *   b: , // Diagnostic: Empty quoteless string
+    *   c: 3,
+    * }
+    * @endcode
+    *
+    * Once this many diagnostics have been collected, the next error ends parsing.
+    * This option only applies when parsing elements with diagnostics.
+    **/
+    size_t max_diagnostics = 100;
 
     /**
     * @brief Returns whether @ref version is greater than or equal to @ref minimum_version.
@@ -0,0 +1,163 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "nlohmann/json.hpp"
+
+namespace jsonh_cpp {
+
+/**
+* @brief Computes semantic hashes of elements, which depend only on their values.
+*
+* Numbers are hashed by value, strings after decoding, and object properties are combined in any order.
+* The hashes are stable across platforms and versions with the same @ref format_version.
+**/
+struct jsonh_semantic_hasher {
+    /**
+    * @brief The version of the hash. Incremented whenever any hash changes.
+    **/
+    static constexpr uint32_t format_version = 1;
+    /**
+    * @brief The initial state of @ref hash_bytes (the FNV-1a offset basis).
+    **/
+    static constexpr uint64_t bytes_offset_basis = 14695981039346656037ull;
+
+    /**
+    * @brief Returns the hash of null.
+    **/
+    static uint64_t hash_null() noexcept {
+        return mix(null_tag);
+    }
+    /**
+    * @brief Returns the hash of a boolean.
+    **/
+    static uint64_t hash_bool(bool value) noexcept {
+        return mix(value ? true_tag : false_tag);
+    }
+    /**
+    * @brief Returns the hash of a number.
+    **/
+    static uint64_t hash_number(double value) noexcept {
+        // Negative zero equals zero
+        if (value == 0) {
+            value = 0;
+        }
+        uint64_t bits = 0;
+        std::memcpy(&bits, &value, sizeof(bits));
+        return mix(number_tag ^ mix(bits));
+    }
+    /**
+    * @brief Returns the hash of a string.
+    **/
+    static uint64_t hash_string(std::string_view value) noexcept {
+        return mix(string_tag ^ mix(hash_bytes(value) ^ value.size()));
+    }
+    /**
+    * @brief Returns the FNV-1a hash of raw bytes, continuing from @c state so that input can be hashed in chunks.
+    *
+    * Unlike the other hashes, this depends on the exact bytes rather than the value.
+    **/
+    static uint64_t hash_bytes(std::string_view bytes, uint64_t state = bytes_offset_basis) noexcept {
+        for (char next : bytes) {
+            state ^= (std::uint8_t)next;
+            state *= 1099511628211ull;
+        }
+        return state;
+    }
+    /**
+    * @brief Returns the initial state of an array hash, passed to @ref add_item.
+    **/
+    static uint64_t start_array() noexcept {
+        return array_tag;
+    }
+    /**
+    * @brief Adds the hash of the next item to the state of an array hash (order-dependent).
+    **/
+    static uint64_t add_item(uint64_t array_state, uint64_t item_hash) noexcept {
+        return mix(array_state ^ item_hash) + item_hash;
+    }
+    /**
+    * @brief Returns the hash of an array from its state after the last item.
+    **/
+    static uint64_t end_array(uint64_t array_state) noexcept {
+        return mix(array_state);
+    }
+    /**
+    * @brief Returns the hash of an object property, summed with the other properties and passed to @ref end_object.
+    **/
+    static uint64_t hash_property(std::string_view property_name, uint64_t value_hash) noexcept {
+        return mix(hash_string(property_name) * 0x9E3779B97F4A7C15ull ^ value_hash);
+    }
+    /**
+    * @brief Returns the hash of an object from the sum of its property hashes (order-independent).
+    **/
+    static uint64_t end_object(uint64_t property_hash_sum, size_t property_count) noexcept {
+        return mix(object_tag ^ mix(property_hash_sum + property_count));
+    }
+
+    /**
+    * @brief Returns the hash of a parsed element.
+    **/
+    static uint64_t hash(const nlohmann::json& element) noexcept {
+        switch (element.type()) {
+            // Null
+            case nlohmann::json::value_t::null: {
+                return hash_null();
+            }
+            // Boolean
+            case nlohmann::json::value_t::boolean: {
+                return hash_bool(element.get<bool>());
+            }
+            // Number
+            case nlohmann::json::value_t::number_integer: case nlohmann::json::value_t::number_unsigned: case nlohmann::json::value_t::number_float: {
+                return hash_number(element.get<double>());
+            }
+            // String
+            case nlohmann::json::value_t::string: {
+                return hash_string(element.get_ref<const std::string&>());
+            }
+            // Array
+            case nlohmann::json::value_t::array: {
+                uint64_t array_state = start_array();
+                for (const nlohmann::json& item : element) {
+                    array_state = add_item(array_state, hash(item));
+                }
+                return end_array(array_state);
+            }
+            // Object
+            case nlohmann::json::value_t::object: {
+                uint64_t property_hash_sum = 0;
+                for (const std::pair<const std::string, nlohmann::json>& property : element.get_ref<const nlohmann::json::object_t&>()) {
+                    property_hash_sum += hash_property(property.first, hash(property.second));
+                }
+                return end_object(property_hash_sum, element.size());
+            }
+            // Other (binary, discarded)
+            default: {
+                return 0;
+            }
+        }
+    }
+
+private:
+    static constexpr uint64_t null_tag = 1;
+    static constexpr uint64_t true_tag = 2;
+    static constexpr uint64_t false_tag = 3;
+    static constexpr uint64_t number_tag = 4;
+    static constexpr uint64_t string_tag = 5;
+    static constexpr uint64_t array_tag = 6;
+    static constexpr uint64_t object_tag = 7;
+
+    static uint64_t mix(uint64_t value) noexcept {
+        // SplitMix64 finalizer
+        value += 0x9E3779B97F4A7C15ull;
+        value = (value ^ (value >> 30)) * 0xBF58476D1CE4E5B9ull;
+        value = (value ^ (value >> 27)) * 0x94D049BB133111EBull;
+        return value ^ (value >> 31);
+    }
+};
+
+}
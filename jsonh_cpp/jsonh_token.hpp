@@ -1,6 +1,8 @@
 #pragma once
 
 #include <string>
+#include <cstddef>
+#include <utility>
 #include "jsonh_token_type.hpp"
 
 namespace jsonh_cpp {
@@ -17,13 +19,25 @@ struct jsonh_token {
     * @brief The value of the token, or an empty string.
     **/
     std::string value;
+    /**
+    * @brief The byte position of the start of the token in the input.
+    **/
+    size_t position;
+    /**
+    * @brief The number of bytes the token spans in the input.
+    *
+    * Tokens that do not correspond to any characters (such as the end of a braceless object) have a length of 0.
+    **/
+    size_t length;
 
     /**
     * @brief Constructs a single JSONH token.
     **/
-    jsonh_token(json_token_type json_type, std::string value = "") noexcept {
+    jsonh_token(json_token_type json_type, std::string value = "", size_t position = 0, size_t length = 0) noexcept {
         this->json_type = json_type;
-        this->value = value;
+        this->value = std::move(value);
+        this->position = position;
+        this->length = length;
     }
 };
 
@@ -1,7 +1,14 @@
 #pragma once
 
+#include <string_view>
+
 namespace jsonh_cpp {
 
+/**
+* @brief The version of the JsonhCpp library.
+**/
+constexpr std::string_view jsonh_cpp_version = "8.0";
+
 /**
 * @brief The major versions of the JSONH specification.
 **/
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <istream>
+#include <streambuf>
+#include <ios>
+#include <memory>
+#include <string>
+#include <utility>
+
+namespace jsonh_cpp {
+
+/**
+* @brief A read-only stream buffer over a shared immutable string.
+*
+* The string is never copied or modified, so any number of buffers (each with its own position) can read it concurrently.
+**/
+class shared_string_buffer : public std::streambuf {
+public:
+    /**
+    * @brief Constructs a buffer that reads from the start of the given string.
+    **/
+    explicit shared_string_buffer(std::shared_ptr<const std::string> source) noexcept {
+        this->source = std::move(source);
+
+        // The get area is only read, so casting away const is safe
+        char* begin = const_cast<char*>(this->source->data());
+        setg(begin, begin, begin + this->source->size());
+    }
+
+protected:
+    pos_type seekoff(off_type offset, std::ios::seekdir anchor, std::ios::openmode which = std::ios::in) override {
+        if (!(which & std::ios::in)) {
+            return pos_type(off_type(-1));
+        }
+
+        // Get target position
+        off_type base_position = 0;
+        if (anchor == std::ios::cur) {
+            base_position = gptr() - eback();
+        }
+        else if (anchor == std::ios::end) {
+            base_position = egptr() - eback();
+        }
+        off_type target_position = base_position + offset;
+
+        // Ensure target position in string
+        if (target_position < 0 || target_position > egptr() - eback()) {
+            return pos_type(off_type(-1));
+        }
+
+        setg(eback(), eback() + target_position, egptr());
+        return pos_type(target_position);
+    }
+    pos_type seekpos(pos_type position, std::ios::openmode which = std::ios::in) override {
+        return seekoff(off_type(position), std::ios::beg, which);
+    }
+    std::streamsize showmanyc() override {
+        return egptr() - gptr();
+    }
+
+private:
+    std::shared_ptr<const std::string> source;
+};
+
+/**
+* @brief A read-only input stream over a shared immutable string (see @ref shared_string_buffer).
+**/
+class shared_string_stream : public std::istream {
+public:
+    /**
+    * @brief Constructs a stream that reads from the start of the given string.
+    **/
+    explicit shared_string_stream(std::shared_ptr<const std::string> source) noexcept
+        : std::istream(nullptr), buffer(std::move(source)) {
+        rdbuf(&buffer);
+    }
+
+private:
+    shared_string_buffer buffer;
+};
+
+}
@@ -50,12 +50,15 @@ public:
     * @brief Returns the current byte position in @ref inner_stream.
     **/
     size_t position() const noexcept {
+        // Reading past the end sets the fail bit, which would make tellg fail
+        inner_stream->clear();
         return inner_stream->tellg();
     }
     /**
     * @brief Sets the current byte position in @ref inner_stream relative to the given anchor.
     **/
     void seek(size_t position, std::ios::seekdir anchor = std::ios::beg) const noexcept {
+        inner_stream->clear();
         inner_stream->seekg(position, anchor);
     }
 
@@ -90,6 +93,13 @@ public:
     * @brief Reads the next UTF-8 rune from @ref inner_stream, without moving forward.
     **/
     std::optional<std::string> peek() const noexcept {
+        // Single byte character performance optimisation
+        int first_byte_as_int = inner_stream->rdbuf()->sgetc();
+        if (first_byte_as_int >= 0 && first_byte_as_int <= 127) {
+            inner_stream->clear();
+            return std::string({ (char)first_byte_as_int });
+        }
+
         size_t original_position = position();
         std::optional<std::string> next = read();
         seek(original_position);
@@ -99,6 +109,16 @@ public:
     * @brief If the next UTF-8 rune is the given option, moves forward by its number of bytes.
     **/
     bool read_one(std::string option) const noexcept {
+        // Single byte character performance optimisation
+        if (option.size() == 1 && (std::uint8_t)option[0] <= 127) {
+            if (inner_stream->rdbuf()->sgetc() == option[0]) {
+                inner_stream->clear();
+                inner_stream->rdbuf()->sbumpc();
+                return true;
+            }
+            return false;
+        }
+
         if (peek() == option) {
             read();
             return true;
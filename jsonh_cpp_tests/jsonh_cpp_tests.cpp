@@ -3,6 +3,8 @@
 
 #include "../jsonh_cpp/jsonh_cpp.hpp"
 
+#include <thread>
+
 using namespace jsonh_cpp;
 
 template <typename T>
@@ -67,6 +69,30 @@ TEST_CASE("NestableBlockCommentTest") {
 
     REQUIRE(!tokens2[1]);
 }
+TEST_CASE("SkipCommentsTest") {
+    std::string jsonh = R"(
+# hash comment
+// line comment
+/* block comment */
+/==* nestable *=/ block *==/
+[1, /* 2 */ 3] // end
+)";
+    jsonh_reader reader(jsonh, jsonh_reader_options({ .skip_comments = true }));
+    std::vector<nonstd::expected<jsonh_token, std::string>> tokens = to_vector(reader.read_element());
+
+    for (const nonstd::expected<jsonh_token, std::string>& token : tokens) {
+        REQUIRE(token);
+    }
+    REQUIRE(tokens.size() == 4);
+    REQUIRE(tokens[0].value().json_type == json_token_type::start_array);
+    REQUIRE(tokens[1].value().value == "1");
+    REQUIRE(tokens[2].value().value == "3");
+    REQUIRE(tokens[3].value().json_type == json_token_type::end_array);
+
+    REQUIRE(!jsonh_reader::parse_element("/=* *==/ 1"));
+    REQUIRE(!jsonh_reader::parse_element("/* 1"));
+    REQUIRE(jsonh_reader::parse_element("/=* *=/ 1\u2028// a\u2029b").value() == 1);
+}
 TEST_CASE("FindPropertyValueTest") {
     std::string jsonh = R"(
 // Original position
@@ -83,6 +109,38 @@ TEST_CASE("FindPropertyValueTest") {
     REQUIRE(reader.find_property_value("c"));
     REQUIRE(reader.parse_element<std::string>().value() == "3");
 }
+TEST_CASE("TokenPositionTest") {
+    std::string jsonh = R"(// comment
+{
+  a b : "c",
+  'd': [1, 私 ]
+}
+)";
+    jsonh_reader reader(jsonh);
+    std::vector<nonstd::expected<jsonh_token, std::string>> tokens = to_vector(reader.read_element());
+
+    std::vector<std::string> sources = { "// comment", "{", "a b", "\"c\"", "'d'", "[", "1", "私", "]", "}" };
+    REQUIRE(tokens.size() == sources.size());
+    for (size_t index = 0; index < tokens.size(); index++) {
+        REQUIRE(tokens[index]);
+        REQUIRE(jsonh.substr(tokens[index].value().position, tokens[index].value().length) == sources[index]);
+    }
+
+    REQUIRE(reader.get_line_and_column(tokens[0].value().position) == std::pair<size_t, size_t>(1, 1));
+    REQUIRE(reader.get_line_and_column(tokens[2].value().position) == std::pair<size_t, size_t>(3, 3));
+    REQUIRE(reader.get_line_and_column(tokens[8].value().position) == std::pair<size_t, size_t>(4, 14));
+    REQUIRE(reader.get_line_and_column(tokens[9].value().position) == std::pair<size_t, size_t>(5, 1));
+
+    jsonh_reader reader2("a: b");
+    std::vector<nonstd::expected<jsonh_token, std::string>> tokens2 = to_vector(reader2.read_element());
+
+    REQUIRE(tokens2[0].value().json_type == json_token_type::start_object);
+    REQUIRE(tokens2[0].value().position == 0);
+    REQUIRE(tokens2[1].value().length == 1);
+    REQUIRE(tokens2[2].value().position == 3);
+    REQUIRE(tokens2[3].value().json_type == json_token_type::end_object);
+    REQUIRE(tokens2[3].value().position == 4);
+}
 TEST_CASE("ParseJsonTest") {
     std::string jsonh = R"(
 {
@@ -141,6 +199,25 @@ TEST_CASE("EscapeSequenceTest") {
 
     REQUIRE(element == "👽 and 👽");
 }
+TEST_CASE("EscapeSequenceRunTest") {
+    std::string jsonh = R"(
+"\u3053\u3093\u306B\u3061\u306F\uD83D\uDC7D\u0041\n\0\x41\\\u0042 \私"
+)";
+    std::string element = jsonh_reader::parse_element<std::string>(jsonh).value();
+
+    REQUIRE(element == std::string("こんにちは👽A\n\0A\\B 私", 29));
+    REQUIRE(!jsonh_reader::parse_element(R"("\u00G0")"));
+    REQUIRE(!jsonh_reader::parse_element(R"("\uD83D\n")"));
+
+    // Long run of surrogate pairs
+    std::string surrogate_pairs;
+    for (size_t index = 0; index < 100000; index++) {
+        surrogate_pairs += "\\uD83D\\uDC7D";
+    }
+    std::string long_element = jsonh_reader::parse_element<std::string>("\"" + surrogate_pairs + "\"").value();
+    REQUIRE(long_element.size() == 400000);
+    REQUIRE(long_element.substr(0, 4) == "\xF0\x9F\x91\xBD");
+}
 TEST_CASE("QuotelessEscapeSequenceTest") {
     std::string jsonh = R"(
 \U0001F47D and \uD83D\uDC7D
@@ -565,4 +642,1042 @@ TEST_CASE("FractionalHexadecimalNumbersTest") {
     REQUIRE(elements.size() == 2);
     REQUIRE(elements[0] == 10.625);
     REQUIRE(elements[1] == 10.62890625);
-}
\ No newline at end of file
+}
+TEST_CASE("NestedElementsTest") {
+    std::string jsonh = R"(
+{
+  a: { b: 1, c: [2, [3]] }
+  d: [{ e: 4 }]
+}
+)";
+    json element = jsonh_reader::parse_element(jsonh).value();
+
+    REQUIRE(element == json::parse(R"({"a":{"b":1,"c":[2,[3]]},"d":[{"e":4}]})"));
+}
+TEST_CASE("ElementLocationsTest") {
+    std::string jsonh = R"({
+  a: [1, 'b']
+  c: {
+    d: null
+  }
+})";
+    jsonh_reader reader(jsonh);
+    std::vector<jsonh_element_location> locations;
+    json element = reader.parse_element(locations).value();
+
+    REQUIRE(locations.size() == 6);
+    REQUIRE(locations[0].pointer == json::json_pointer(""));
+    REQUIRE(locations[0].position == 0);
+    REQUIRE(locations[0].length == jsonh.size());
+    REQUIRE(locations[1].pointer == json::json_pointer("/a"));
+    REQUIRE(jsonh.substr(locations[1].position, locations[1].length) == "[1, 'b']");
+    REQUIRE(locations[2].pointer == json::json_pointer("/a/0"));
+    REQUIRE(locations[3].pointer == json::json_pointer("/a/1"));
+    REQUIRE(jsonh.substr(locations[3].position, locations[3].length) == "'b'");
+    REQUIRE(locations[3].line == 2);
+    REQUIRE(locations[3].column == 10);
+    REQUIRE(locations[4].pointer == json::json_pointer("/c"));
+    REQUIRE(locations[5].pointer == json::json_pointer("/c/d"));
+    REQUIRE(locations[5].line == 4);
+    REQUIRE(locations[5].column == 8);
+    REQUIRE(element.at(locations[5].pointer) == nullptr);
+}
+TEST_CASE("ParseBinaryTest") {
+    std::string jsonh = R"(
+{
+  // comment
+  a: [1, 2.5, true, null]
+  b: { c: '''text''' }
+  "": []
+}
+)";
+    json element = jsonh_reader::parse_element(jsonh).value();
+
+    std::vector<std::uint8_t> cbor = jsonh_reader(jsonh).parse_binary(jsonh_binary_format::cbor).value();
+    REQUIRE(json::from_cbor(cbor) == element);
+    std::vector<std::uint8_t> msgpack = jsonh_reader(jsonh).parse_binary(jsonh_binary_format::msgpack).value();
+    REQUIRE(json::from_msgpack(msgpack) == element);
+    std::vector<std::uint8_t> bson = jsonh_reader(jsonh).parse_binary(jsonh_binary_format::bson).value();
+    REQUIRE(json::from_bson(bson) == element);
+    std::vector<std::uint8_t> ubjson = jsonh_reader(jsonh).parse_binary(jsonh_binary_format::ubjson).value();
+    REQUIRE(json::from_ubjson(ubjson) == element);
+
+    REQUIRE(jsonh_reader("0x10").parse_binary(jsonh_binary_format::cbor).value() == json::to_cbor(16.0));
+    REQUIRE(!jsonh_reader("[1]").parse_binary(jsonh_binary_format::bson));
+
+    // Primitives are encoded the same as nlohmann/json
+    std::vector<std::string> primitive_jsonhs = { "null", "true", "1.5", "0.1", "-1e300", "1e39", "''" };
+    for (size_t length : { 23, 24, 31, 32, 127, 128, 255, 256, 32767, 32768, 65535, 65536 }) {
+        primitive_jsonhs.push_back("'" + std::string(length, 'a') + "'");
+    }
+    for (const std::string& primitive_jsonh : primitive_jsonhs) {
+        json primitive = jsonh_reader::parse_element(primitive_jsonh).value();
+        REQUIRE(jsonh_reader(primitive_jsonh).parse_binary(jsonh_binary_format::cbor).value() == json::to_cbor(primitive));
+        REQUIRE(jsonh_reader(primitive_jsonh).parse_binary(jsonh_binary_format::msgpack).value() == json::to_msgpack(primitive));
+        REQUIRE(jsonh_reader(primitive_jsonh).parse_binary(jsonh_binary_format::ubjson).value() == json::to_ubjson(primitive));
+        REQUIRE(jsonh_reader("{ a: " + primitive_jsonh + " }").parse_binary(jsonh_binary_format::bson).value() == json::to_bson(json({ { "a", primitive } })));
+    }
+    std::string names_jsonh = "{ '" + std::string(31, 'a') + "': 1, '" + std::string(256, 'b') + "': 2, '': 3 }";
+    json names_element = jsonh_reader::parse_element(names_jsonh).value();
+    REQUIRE(json::from_cbor(jsonh_reader(names_jsonh).parse_binary(jsonh_binary_format::cbor).value()) == names_element);
+    REQUIRE(json::from_msgpack(jsonh_reader(names_jsonh).parse_binary(jsonh_binary_format::msgpack).value()) == names_element);
+    REQUIRE(json::from_ubjson(jsonh_reader(names_jsonh).parse_binary(jsonh_binary_format::ubjson).value()) == names_element);
+
+    // Stream output
+    std::ostringstream stream;
+    REQUIRE(jsonh_reader(jsonh).parse_binary(jsonh_binary_format::cbor, stream));
+    std::string stream_bytes = stream.str();
+    REQUIRE(std::vector<std::uint8_t>(stream_bytes.begin(), stream_bytes.end()) == cbor);
+
+    // Single element
+    REQUIRE(jsonh_reader("[1] [2]").parse_binary(jsonh_binary_format::cbor));
+    REQUIRE(!jsonh_reader("[1] [2]", jsonh_reader_options({ .parse_single_element = true })).parse_binary(jsonh_binary_format::cbor));
+    REQUIRE(jsonh_reader("[1] // comment", jsonh_reader_options({ .parse_single_element = true })).parse_binary(jsonh_binary_format::cbor));
+}
+TEST_CASE("SaxParseTest") {
+    std::string jsonh = R"(
+{
+  a: [1, -2, 2.5, 0x10, 1e2, true, null]
+  b: { c: text }
+  d: [{ e: 3 }]
+}
+)";
+    json element;
+    nlohmann::detail::json_sax_dom_parser<json, nlohmann::detail::string_input_adapter_type> sax(element);
+    REQUIRE(jsonh_reader(jsonh).sax_parse(&sax));
+
+    REQUIRE(element == jsonh_reader::parse_element(jsonh).value());
+    REQUIRE(element["a"][0].is_number_unsigned());
+    REQUIRE(element["a"][1].is_number_integer());
+    REQUIRE(element["a"][2].is_number_float());
+    REQUIRE(element["a"][3].is_number_unsigned());
+    REQUIRE(element["a"][4].is_number_float());
+
+    json element2;
+    nlohmann::detail::json_sax_dom_callback_parser<json, nlohmann::detail::string_input_adapter_type> sax2(element2, [](int, json::parse_event_t event, json& parsed) {
+        return !(event == json::parse_event_t::key && parsed == "b");
+    });
+    REQUIRE(jsonh_reader(jsonh).sax_parse(&sax2));
+
+    REQUIRE(element2.size() == 2);
+    REQUIRE(!element2.contains("b"));
+
+    // Integers are exact beyond the precision of double
+    json element4;
+    nlohmann::detail::json_sax_dom_parser<json, nlohmann::detail::string_input_adapter_type> sax4(element4);
+    REQUIRE(jsonh_reader("[18446744073709551615, 9007199254740993, -9223372036854775808, 0xFFFF_FFFF_FFFF_FFFF, 18446744073709551616, -9223372036854775809]").sax_parse(&sax4));
+    REQUIRE(element4[0].get<uint64_t>() == UINT64_MAX);
+    REQUIRE(element4[1].get<uint64_t>() == 9007199254740993ull);
+    REQUIRE(element4[2].get<int64_t>() == INT64_MIN);
+    REQUIRE(element4[3].get<uint64_t>() == UINT64_MAX);
+    REQUIRE(element4[4].is_number_float());
+    REQUIRE(element4[5].is_number_float());
+
+    json element3;
+    nlohmann::detail::json_sax_dom_parser<json, nlohmann::detail::string_input_adapter_type> sax3(element3, false);
+    REQUIRE(!jsonh_reader("[1, 2").sax_parse(&sax3));
+
+    // Single element
+    json element5;
+    nlohmann::detail::json_sax_dom_parser<json, nlohmann::detail::string_input_adapter_type> sax5(element5, false);
+    REQUIRE(!jsonh_reader("[1] [2]", jsonh_reader_options({ .parse_single_element = true })).sax_parse(&sax5));
+    json element6;
+    nlohmann::detail::json_sax_dom_parser<json, nlohmann::detail::string_input_adapter_type> sax6(element6);
+    REQUIRE(jsonh_reader("[1] // comment", jsonh_reader_options({ .parse_single_element = true })).sax_parse(&sax6));
+    REQUIRE(element6 == json::parse("[1]"));
+}
+TEST_CASE("CacheTest") {
+    std::filesystem::path path = std::filesystem::temp_directory_path() / "jsonh_cpp_cache_test.jsonh";
+    std::filesystem::path cache = jsonh_cache::cache_path(path);
+    std::filesystem::remove(cache);
+    {
+        std::ofstream(path) << "a: [1, 2], b: c";
+    }
+
+    // Parse and write cache
+    nonstd::expected<json, std::string> element = jsonh_cache::load(path);
+    REQUIRE(element);
+    REQUIRE(element.value() == json::parse(R"({"a":[1,2],"b":"c"})"));
+    REQUIRE(std::filesystem::exists(cache));
+
+    // Load from cache
+    REQUIRE(jsonh_cache::load(path).value() == element.value());
+
+    // Different options rewrite cache
+    REQUIRE(jsonh_cache::load(path, jsonh_reader_options({ .max_depth = 1 })).error() != "");
+
+    // Modified source rewrites cache
+    {
+        std::ofstream(path) << "a: [3]";
+    }
+    REQUIRE(jsonh_cache::load(path).value() == json::parse(R"({"a":[3]})"));
+
+    // Corrupt cache is ignored
+    {
+        std::ofstream(cache, std::ios::binary | std::ios::trunc) << "JSONHC";
+    }
+    REQUIRE(jsonh_cache::load(path).value() == json::parse(R"({"a":[3]})"));
+
+    // Concurrent writers
+    std::filesystem::remove(cache);
+    std::vector<std::thread> threads;
+    std::atomic<int> success_count = 0;
+    for (int index = 0; index < 8; index++) {
+        threads.emplace_back([&]() {
+            if (jsonh_cache::load(path).value() == json::parse(R"({"a":[3]})")) {
+                success_count++;
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(success_count == 8);
+    REQUIRE(jsonh_cache::load(path).value() == json::parse(R"({"a":[3]})"));
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(path.parent_path())) {
+        REQUIRE(!entry.path().filename().string().starts_with(cache.filename().string() + ".tmp"));
+    }
+
+    std::filesystem::remove(path);
+    std::filesystem::remove(cache);
+}
+TEST_CASE("IndexTest") {
+    std::string jsonh = R"(
+[
+  0, "1", { two: 2 }, [3], # comment
+  four, 5, 6
+]
+)";
+    jsonh_reader reader(jsonh);
+    nonstd::expected<jsonh_index, std::string> index = reader.build_index(3);
+    REQUIRE(index);
+    REQUIRE(index.value().is_array);
+    REQUIRE(index.value().item_count == 7);
+    REQUIRE(index.value().item_positions.size() == 3);
+
+    // Round trip
+    index = jsonh_index::from_bytes(index.value().to_bytes());
+    REQUIRE(index);
+
+    json expected = jsonh_reader::parse_element(jsonh).value();
+    for (size_t item_index = 0; item_index < 7; item_index++) {
+        REQUIRE(reader.seek_item(index.value(), item_index));
+        REQUIRE(reader.parse_element().value() == expected[item_index]);
+    }
+    REQUIRE(!reader.seek_item(index.value(), 7));
+
+    std::string jsonh2 = R"(
+a: 1
+b: { c: [2] }
+a: three
+)";
+    jsonh_reader reader2(jsonh2);
+    nonstd::expected<jsonh_index, std::string> index2 = reader2.build_index();
+    REQUIRE(index2);
+    REQUIRE(!index2.value().is_array);
+    REQUIRE(index2.value().properties.size() == 3);
+
+    REQUIRE(reader2.seek_property(index2.value(), "b"));
+    REQUIRE(reader2.parse_element().value() == json::parse(R"({"c":[2]})"));
+    REQUIRE(reader2.seek_property(index2.value(), "a"));
+    REQUIRE(reader2.parse_element().value() == "three");
+    REQUIRE(!reader2.seek_property(index2.value(), "c"));
+
+    // Index of different input
+    REQUIRE(!jsonh_reader(jsonh2.substr(0, jsonh2.size() - 3)).seek_property(index2.value(), "a"));
+    REQUIRE(!jsonh_reader("x" + jsonh2).seek_property(index2.value(), "a"));
+    std::string jsonh3 = jsonh;
+    jsonh3[jsonh3.find('6')] = '7';
+    REQUIRE(!jsonh_reader(jsonh3).seek_item(index.value(), 0));
+    // Same length change far from the end
+    std::string jsonh4 = jsonh2 + std::string(1000, ' ');
+    jsonh_reader reader4(jsonh4);
+    nonstd::expected<jsonh_index, std::string> index4 = reader4.build_index();
+    REQUIRE(index4);
+    jsonh4[jsonh4.find('1')] = '2';
+    REQUIRE(!jsonh_reader(jsonh4).seek_property(index4.value(), "b"));
+    REQUIRE(jsonh_reader(jsonh).seek_item(index.value(), 0));
+
+    REQUIRE(!jsonh_index::from_bytes({ 'J', 'S', 'O', 'N' }));
+}
+TEST_CASE("ParseRangeTest") {
+    std::string jsonh = R"(
+[
+  { a: "]}", b: '''
+    ]
+    ''' }, # ]
+  [ \], /* ] */ @"\" ],
+  @b\, #[
+  x,
+  [ /=* ] *=/ 'y' ],
+  z
+]
+)";
+    json expected = jsonh_reader::parse_element(jsonh).value();
+    REQUIRE(expected.size() == 6);
+
+    for (size_t start_index = 0; start_index <= 6; start_index++) {
+        for (size_t end_index = start_index; end_index <= 7; end_index++) {
+            json items = jsonh_reader(jsonh).parse_range(start_index, end_index).value();
+
+            REQUIRE(items.size() == std::min<size_t>(end_index, 6) - start_index);
+            for (size_t item_index = 0; item_index < items.size(); item_index++) {
+                REQUIRE(items[item_index] == expected[start_index + item_index]);
+            }
+        }
+    }
+
+    jsonh_reader reader(jsonh);
+    jsonh_index index = reader.build_index(4).value();
+    REQUIRE(reader.parse_range(index, 1, 3).value() == json::array({ expected[1], expected[2] }));
+    REQUIRE(reader.parse_range(index, 5, 10).value() == json::array({ expected[5] }));
+
+    REQUIRE(!jsonh_reader("[[1, 2]").parse_range(1, 2));
+    REQUIRE(!jsonh_reader("{}").parse_range(0, 1));
+}
+TEST_CASE("ParseItemsTest") {
+    std::string jsonh = R"(
+# items
+[
+  { a: 1 }, // first
+  [2]
+  three
+  4,
+]
+)";
+    std::vector<json> items = {};
+    jsonh_reader reader(jsonh, jsonh_reader_options({ .parse_single_element = true }));
+    for (nonstd::expected<json, std::string>&& item : reader.parse_items()) {
+        REQUIRE(item);
+        items.push_back(std::move(item.value()));
+    }
+    REQUIRE(json(items) == jsonh_reader::parse_element(jsonh).value());
+
+    std::vector<int> numbers = {};
+    jsonh_reader reader2("[1, 2, 3]");
+    for (nonstd::expected<int, std::string>&& number : reader2.parse_items<int>()) {
+        numbers.push_back(number.value());
+    }
+    REQUIRE(numbers == std::vector<int>({ 1, 2, 3 }));
+
+    std::vector<nonstd::expected<json, std::string>> results = to_vector(jsonh_reader("[1, {]").parse_items());
+    REQUIRE(results.size() == 2);
+    REQUIRE(results[0].value() == 1);
+    REQUIRE(!results[1]);
+
+    // Errors leave the items
+    jsonh_reader reader3("[1, {]");
+    REQUIRE(!to_vector(reader3.parse_items()).back());
+    REQUIRE(!reader3.checkpoint().is_in_items);
+    jsonh_reader reader4("[[1]]", jsonh_reader_options({ .max_depth = 1 }));
+    REQUIRE(!to_vector(reader4.parse_items()).back());
+    REQUIRE(!reader4.checkpoint().is_in_items);
+    jsonh_reader reader5("[1, 2", jsonh_reader_options({ .max_depth = 0 }));
+    REQUIRE(!to_vector(reader5.parse_items()).back());
+    REQUIRE(!reader5.checkpoint().is_in_items);
+
+    REQUIRE(!to_vector(jsonh_reader("[1] 2", jsonh_reader_options({ .parse_single_element = true })).parse_items()).back());
+}
+TEST_CASE("CheckpointTest") {
+    std::string jsonh = R"(
+[
+  { a: 1 }, // first
+  [2]
+  three, /* fourth */ 4
+  five
+]
+)";
+    json expected = jsonh_reader::parse_element(jsonh).value();
+
+    // Read two items and take checkpoint
+    std::vector<std::uint8_t> checkpoint_bytes;
+    {
+        jsonh_reader reader(jsonh);
+        size_t item_index = 0;
+        for (nonstd::expected<json, std::string>&& item : reader.parse_items()) {
+            REQUIRE(item.value() == expected[item_index]);
+            item_index++;
+            if (item_index == 2) {
+                checkpoint_bytes = reader.checkpoint().to_bytes();
+                break;
+            }
+        }
+    }
+
+    // Resume from checkpoint
+    nonstd::expected<jsonh_checkpoint, std::string> checkpoint = jsonh_checkpoint::from_bytes(checkpoint_bytes);
+    REQUIRE(checkpoint);
+    REQUIRE(checkpoint.value().item_count == 2);
+
+    jsonh_reader reader(jsonh);
+    REQUIRE(reader.resume(checkpoint.value()));
+    std::vector<json> items = {};
+    for (nonstd::expected<json, std::string>&& item : reader.parse_items()) {
+        items.push_back(item.value());
+    }
+    REQUIRE(json(items) == json::array({ expected[2], expected[3], expected[4] }));
+
+    // Checkpoint between elements
+    jsonh_reader reader2("[1] [2]");
+    REQUIRE(reader2.parse_element().value() == json::array({ 1 }));
+    jsonh_reader reader3("[1] [2]");
+    REQUIRE(reader3.resume(reader2.checkpoint()));
+    REQUIRE(reader3.parse_element().value() == json::array({ 2 }));
+
+    REQUIRE(!jsonh_reader("[]").resume(jsonh_checkpoint({ .position = 100 })));
+    REQUIRE(!jsonh_checkpoint::from_bytes({ 'J' }));
+}
+TEST_CASE("SharedSourceTest") {
+    std::string items;
+    for (size_t index = 0; index < 1000; index++) {
+        items += "{ id: " + std::to_string(index) + ", name: 'item " + std::to_string(index) + "' },\n";
+    }
+    std::shared_ptr<const std::string> source = std::make_shared<const std::string>("[\n" + items + "]");
+
+    jsonh_reader index_reader(source);
+    jsonh_index index = index_reader.build_index(100).value();
+
+    // Parse different regions concurrently
+    std::vector<json> results(4);
+    std::vector<std::thread> threads = {};
+    for (size_t thread_index = 0; thread_index < results.size(); thread_index++) {
+        threads.push_back(std::thread([&, thread_index]() {
+            jsonh_reader reader(source);
+            results[thread_index] = reader.parse_range(index, thread_index * 250, (thread_index + 1) * 250).value();
+        }));
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+
+    json expected = jsonh_reader::parse_element(*source).value();
+    for (size_t thread_index = 0; thread_index < results.size(); thread_index++) {
+        REQUIRE(results[thread_index].size() == 250);
+        for (size_t item_index = 0; item_index < 250; item_index++) {
+            REQUIRE(results[thread_index][item_index] == expected[(thread_index * 250) + item_index]);
+        }
+    }
+
+    // Seek past end
+    jsonh_reader reader(source);
+    REQUIRE(!reader.resume(jsonh_checkpoint({ .position = source->size() + 1 })));
+    REQUIRE(reader.resume(jsonh_checkpoint({ .position = source->size() })));
+}
+TEST_CASE("JsonFastPathTest") {
+    std::vector<std::string> inputs = {
+        R"({"a": 1, "b": [true, false, null], "c": {"d": "e\nfé"}, "g": -1.5e3, "h": 0, "i": ""})",
+        R"([1, 2, 3])",
+        R"({"a": 1, "a": 2})",
+        "[\n  \"é\",\n  {}\n,[]\n]",
+        // JSONH-only constructs
+        R"({"a": 1, b: 2})",
+        R"([1, 2,])",
+        "{\"a\": \"x\" # comment\n}",
+        R"([0x10, 1_000, .5, +1])",
+        R"(["""multi""", 'single', @"verbatim\"])",
+        R"([true x, null y, 1 z])",
+        "[1\n2]",
+        R"({"a": {"b": {"c": [1]}}})",
+        // Invalid
+        R"({"a": 1)",
+        R"([1, 2)",
+    };
+
+    for (const std::string& input : inputs) {
+        std::vector<jsonh_element_location> locations = {};
+        nonstd::expected<json, std::string> element = jsonh_reader(input).parse_element();
+        nonstd::expected<json, std::string> jsonh_element = jsonh_reader(input).parse_element(locations);
+
+        REQUIRE(!!element == !!jsonh_element);
+        if (element) {
+            REQUIRE(element.value() == jsonh_element.value());
+        }
+        else {
+            REQUIRE(element.error() == jsonh_element.error());
+        }
+    }
+
+    // Fall back for max depth
+    REQUIRE(jsonh_reader(R"({"a": [1]})", jsonh_reader_options({ .max_depth = 1 })).parse_element().error() == "Exceeded max depth");
+
+    // Fall back for incomplete inputs
+    REQUIRE(jsonh_reader(R"([1, 2)", jsonh_reader_options({ .incomplete_inputs = true })).parse_element().value() == json::array({ 1, 2 }));
+
+    // Number tokens
+    std::vector<jsonh_token> tokens = {};
+    for (const nonstd::expected<jsonh_token, std::string>& token : to_vector(jsonh_reader("[-1.5e3, 2 , 3x]").read_element())) {
+        tokens.push_back(token.value());
+    }
+    REQUIRE(tokens[1].json_type == json_token_type::number);
+    REQUIRE(tokens[1].value == "-1.5e3");
+    REQUIRE(tokens[1].length == 6);
+    REQUIRE(tokens[2].json_type == json_token_type::number);
+    REQUIRE(tokens[3].json_type == json_token_type::string);
+    REQUIRE(tokens[3].value == "3x");
+}
+TEST_CASE("ParseNumberArrayTest") {
+    std::string jsonh = R"(
+[
+  1, -2.5, 3e2 # comment
+  0x10, 1_000
+  +7,
+]
+)";
+    std::vector<double> doubles = jsonh_reader(jsonh).parse_number_array<double>().value();
+    REQUIRE(doubles == std::vector<double>({ 1, -2.5, 300, 16, 1000, 7 }));
+
+    std::vector<int64_t> integers = jsonh_reader("[1, -2, 3e2, 0x10, 9007199254740993]").parse_number_array<int64_t>().value();
+    REQUIRE(integers == std::vector<int64_t>({ 1, -2, 300, 16, 9007199254740993 }));
+
+    REQUIRE(jsonh_reader("[1, 2.5]").parse_number_array<int64_t>().error() == "Expected integer in number array");
+    REQUIRE(jsonh_reader("[1, -2]").parse_number_array<uint8_t>().error() == "Number out of range in number array");
+    REQUIRE(jsonh_reader("[1, 300]").parse_number_array<uint8_t>().error() == "Number out of range in number array");
+    REQUIRE(jsonh_reader("[1, a]").parse_number_array<double>().error() == "Expected number in number array");
+    REQUIRE(jsonh_reader("[1 2]").parse_number_array<double>().error() == "Expected number in number array");
+    REQUIRE(!jsonh_reader("[1, 2").parse_number_array<double>());
+    REQUIRE(jsonh_reader("[]").parse_number_array<float>().value().empty());
+}
+TEST_CASE("PropertyNameTest") {
+    std::string long_name = "a property name longer than the small string buffer";
+
+    // JSON and JSONH paths
+    for (const std::string& jsonh : { "[{\"" + long_name + "\": 1}, {\"" + long_name + "\": 2, \"" + long_name + "\": 3}]", "[{'" + long_name + "': 1}, {'" + long_name + "': 2, '" + long_name + "': 3,}]" }) {
+        json element = jsonh_reader::parse_element(jsonh).value();
+        REQUIRE(element[0][long_name] == 1);
+        REQUIRE(element[1].size() == 1);
+        REQUIRE(element[1][long_name] == 3);
+    }
+
+    std::vector<nonstd::expected<jsonh_token, std::string>> tokens = to_vector(jsonh_reader("{'" + long_name + "': '" + long_name + "'}").read_element());
+    REQUIRE(tokens[1].value().value == long_name);
+    REQUIRE(tokens[2].value().value == long_name);
+}
+TEST_CASE("DuplicatePropertyPolicyTest") {
+    jsonh_reader_options last_wins_options = jsonh_reader_options();
+    jsonh_reader_options first_wins_options = jsonh_reader_options();
+    first_wins_options.duplicate_property_policy = jsonh_duplicate_property_policy::first_wins;
+    jsonh_reader_options error_options = jsonh_reader_options();
+    error_options.duplicate_property_policy = jsonh_duplicate_property_policy::error;
+    jsonh_reader_options collect_options = jsonh_reader_options();
+    collect_options.duplicate_property_policy = jsonh_duplicate_property_policy::collect;
+
+    // JSON and JSONH paths
+    for (const std::string& jsonh : { std::string(R"({"a": 1, "b": {"a": 2}, "a": [3]})"), std::string("{a: 1, b: {a: 2}, a: [3],}") }) {
+        REQUIRE(jsonh_reader::parse_element(jsonh, last_wins_options).value() == json::parse(R"({"a": [3], "b": {"a": 2}})"));
+        REQUIRE(jsonh_reader::parse_element(jsonh, first_wins_options).value() == json::parse(R"({"a": 1, "b": {"a": 2}})"));
+        REQUIRE(jsonh_reader::parse_element(jsonh, collect_options).value() == json::parse(R"({"a": [1, [3]], "b": {"a": 2}})"));
+        REQUIRE(jsonh_reader::parse_element(jsonh, error_options).error() == "Duplicate property name");
+    }
+    REQUIRE(jsonh_reader::parse_element("{a: 1, a: [2], a: 3}", collect_options).value() == json::parse(R"({"a": [1, [2], 3]})"));
+    REQUIRE(jsonh_reader::parse_element("[{a: 1}, {a: 2}, {b: {a: 3}, a: 4}]", error_options));
+
+    // Braceless object
+    REQUIRE(jsonh_reader::parse_element("a: 1\nb: 2\na: 3", error_options).error() == "Duplicate property name");
+
+    // Tokens
+    std::vector<nonstd::expected<jsonh_token, std::string>> tokens = to_vector(jsonh_reader("{a: 1, a: 2}", error_options).read_element());
+    REQUIRE(tokens.back().error() == "Duplicate property name");
+    REQUIRE(tokens[2].value().value == "1");
+
+    // Large object
+    std::string large_jsonh = "{";
+    for (int index = 0; index < 40; index++) {
+        large_jsonh += "p" + std::to_string(index) + ": " + std::to_string(index) + ",";
+    }
+    REQUIRE(jsonh_reader::parse_element(large_jsonh + "}", error_options));
+    REQUIRE(jsonh_reader::parse_element(large_jsonh + "p20: 0}", error_options).error() == "Duplicate property name");
+    REQUIRE(jsonh_reader::parse_element(large_jsonh + "p20: 0}", first_wins_options).value()["p20"] == 20);
+
+    // SAX
+    json element;
+    nlohmann::detail::json_sax_dom_parser<json, nlohmann::detail::string_input_adapter_type> sax(element);
+    jsonh_reader sax_reader("{a: {b: [1]}, c: 2, a: {d: [{}]}, e: {a: 3, a: 4}}", first_wins_options);
+    REQUIRE(sax_reader.sax_parse(&sax));
+    REQUIRE(element == json::parse(R"({"a": {"b": [1]}, "c": 2, "e": {"a": 3}})"));
+}
+TEST_CASE("DiagnosticsTest") {
+    std::string jsonh = R"(a: 1
+b: ,
+c: [1, }, 3]
+d: {
+  e: 'unclosed
+)";
+    std::vector<jsonh_diagnostic> diagnostics;
+    json element = jsonh_reader(jsonh).parse_element(diagnostics).value();
+    REQUIRE(element == json::parse(R"({"a": 1, "c": [1, 3], "d": {}})"));
+    REQUIRE(diagnostics.size() == 4);
+    REQUIRE(diagnostics[0].message == "Empty quoteless string");
+    REQUIRE(diagnostics[0].line == 2);
+    REQUIRE(diagnostics[0].column == 4);
+    REQUIRE(diagnostics[1].line == 3);
+    REQUIRE(diagnostics[2].line == 6);
+    REQUIRE(diagnostics[3].message == "Expected `}` to end object, got end of input");
+
+    // No errors
+    std::vector<jsonh_diagnostic> no_diagnostics;
+    REQUIRE(jsonh_reader("{a: [1, 2], b: 3}").parse_element(no_diagnostics).value() == json::parse(R"({"a": [1, 2], "b": 3})"));
+    REQUIRE(no_diagnostics.empty());
+
+    // Extra element
+    jsonh_reader_options single_element_options = jsonh_reader_options();
+    single_element_options.parse_single_element = true;
+    std::vector<jsonh_diagnostic> extra_element_diagnostics;
+    REQUIRE(jsonh_reader("[1, 2] 3", single_element_options).parse_element(extra_element_diagnostics).value() == json::parse("[1, 2]"));
+    REQUIRE(extra_element_diagnostics.size() == 1);
+
+    // Max diagnostics
+    jsonh_reader_options limited_options = jsonh_reader_options();
+    limited_options.max_diagnostics = 2;
+    std::vector<jsonh_diagnostic> limited_diagnostics;
+    REQUIRE(!jsonh_reader("[,,,1]", limited_options).parse_element(limited_diagnostics));
+    REQUIRE(limited_diagnostics.size() == 2);
+
+    // Exceeded max depth
+    jsonh_reader_options depth_options = jsonh_reader_options();
+    depth_options.max_depth = 2;
+    std::vector<jsonh_diagnostic> depth_diagnostics;
+    REQUIRE(jsonh_reader("[[[1]]]", depth_options).parse_element(depth_diagnostics).error() == "Exceeded max depth");
+
+    // Not recovering without diagnostics
+    REQUIRE(!jsonh_reader::parse_element("[1, }, 3]"));
+}
+TEST_CASE("LineLexerTest") {
+    jsonh_line_lexer lexer = jsonh_line_lexer();
+
+    // Single line
+    std::vector<jsonh_lexeme> lexemes;
+    jsonh_line_lexer::state end_state = lexer.lex_line("{ \"a\": 0x1F, b c: [true, null, text ], # comment", jsonh_line_lexer::state(), lexemes);
+    REQUIRE(end_state == jsonh_line_lexer::state());
+    std::vector<jsonh_lexeme_type> types;
+    for (const jsonh_lexeme& lexeme : lexemes) {
+        types.push_back(lexeme.type);
+    }
+    REQUIRE(types == std::vector<jsonh_lexeme_type>({
+        jsonh_lexeme_type::start_object, jsonh_lexeme_type::property_name, jsonh_lexeme_type::colon, jsonh_lexeme_type::number, jsonh_lexeme_type::comma,
+        jsonh_lexeme_type::property_name, jsonh_lexeme_type::colon, jsonh_lexeme_type::start_array, jsonh_lexeme_type::true_bool, jsonh_lexeme_type::comma,
+        jsonh_lexeme_type::null, jsonh_lexeme_type::comma, jsonh_lexeme_type::string, jsonh_lexeme_type::end_array, jsonh_lexeme_type::comma, jsonh_lexeme_type::comment,
+    }));
+    REQUIRE(lexemes[5].position == 13);
+    REQUIRE(lexemes[5].length == 3);
+    REQUIRE(lexemes[12].length == 4);
+
+    // Numbers are classified like the reader parses them
+    for (std::string number : { "1e5", "1.5e-2", "0x1e+2", "0x1E-2", "0x1e2", "0b1e+1", "0b1e1", "0o7e-1", "0o7e2", "-0x1_f" }) {
+        lexemes.clear();
+        lexer.lex_line("[" + number + "]", jsonh_line_lexer::state(), lexemes);
+        REQUIRE(lexemes[1].type == jsonh_lexeme_type::number);
+        REQUIRE(lexemes[1].length == number.size());
+        REQUIRE(jsonh_reader::parse_element("[" + number + "]").value()[0].is_number());
+    }
+    for (std::string string : { "0xe+1", "1e", "0b1e" }) {
+        lexemes.clear();
+        lexer.lex_line("[" + string + "]", jsonh_line_lexer::state(), lexemes);
+        REQUIRE(lexemes[1].type != jsonh_lexeme_type::number);
+    }
+
+    // Multi-line states
+    std::vector<std::string_view> lines = { "a: '''", "  multi", "  ''' /=*", "  *=/ b: 1", "c: \\", "d" };
+    std::vector<jsonh_line_lexer::state> line_states;
+    std::vector<std::vector<jsonh_lexeme>> line_lexemes;
+    REQUIRE(lexer.relex(lines, line_states, line_lexemes, 0, lines.size()) == lines.size());
+    REQUIRE(line_states[1].context == jsonh_line_lexer::state::context_type::string);
+    REQUIRE(line_states[1].counter == 3);
+    REQUIRE(line_states[2].context == jsonh_line_lexer::state::context_type::string);
+    REQUIRE(line_states[3].context == jsonh_line_lexer::state::context_type::block_comment);
+    REQUIRE(line_states[3].counter == 1);
+    REQUIRE(line_states[4] == jsonh_line_lexer::state());
+    REQUIRE(line_states[5].context == jsonh_line_lexer::state::context_type::quoteless_string);
+    REQUIRE(line_lexemes[3][0].type == jsonh_lexeme_type::comment);
+    REQUIRE(line_lexemes[3][0].length == 5);
+    REQUIRE(line_lexemes[3][1].type == jsonh_lexeme_type::property_name);
+    REQUIRE(line_lexemes[5][0].type == jsonh_lexeme_type::string);
+
+    // Edit that does not change states stops at the next line
+    lines[1] = "  changed";
+    REQUIRE(lexer.relex(lines, line_states, line_lexemes, 1, 2) == 2);
+
+    // Edit that changes states continues until they reconverge
+    std::vector<std::string_view> comment_lines = { "a: 1", "b: /* x", "*/ c: 2", "d: 3", "e: 4" };
+    REQUIRE(lexer.relex(comment_lines, line_states, line_lexemes, 0, comment_lines.size()) == comment_lines.size());
+    REQUIRE(line_lexemes.size() == comment_lines.size());
+    REQUIRE(line_states[2].context == jsonh_line_lexer::state::context_type::block_comment);
+    comment_lines[1] = "b: 2";
+    REQUIRE(lexer.relex(comment_lines, line_states, line_lexemes, 1, 2) == 3);
+    REQUIRE(line_states[2] == jsonh_line_lexer::state());
+    REQUIRE(line_lexemes[2][0].type == jsonh_lexeme_type::string);
+}
+TEST_CASE("DocumentTest") {
+    std::string jsonh = R"({
+  a: [1, 23, { b: "text" }], c: 4
+  d: { e: [true, null] }, f: 5
+})";
+    jsonh_document document = jsonh_document::parse(jsonh).value();
+
+    auto require_matches_full_parse = [&]() -> void {
+        std::vector<jsonh_element_location> locations;
+        json element = jsonh_reader(document.input()).parse_element(locations).value();
+        REQUIRE(document.element() == element);
+        REQUIRE(document.locations().size() == locations.size());
+        for (size_t index = 0; index < locations.size(); index++) {
+            REQUIRE(document.locations()[index].pointer == locations[index].pointer);
+            REQUIRE(document.locations()[index].position == locations[index].position);
+            REQUIRE(document.locations()[index].length == locations[index].length);
+            REQUIRE(document.locations()[index].line == locations[index].line);
+            REQUIRE(document.locations()[index].column == locations[index].column);
+        }
+    };
+
+    // Edit number
+    REQUIRE(document.apply_edit(jsonh_document::edit({ jsonh.find("23") + 1, 1, "456" })));
+    REQUIRE(document.element()["a"][1] == 2456);
+    require_matches_full_parse();
+
+    // Insert items and lines
+    REQUIRE(document.apply_edit(jsonh_document::edit({ document.input().find("true") + 4, 0, ",\n      false, 'x'" })));
+    REQUIRE(document.element()["d"]["e"] == json::parse(R"([true, false, "x", null])"));
+    require_matches_full_parse();
+
+    // Edit string changing its property
+    REQUIRE(document.apply_edit(jsonh_document::edit({ document.input().find("text") + 1, 2, "éé" })));
+    REQUIRE(document.element()["a"][2]["b"] == "téét");
+    require_matches_full_parse();
+
+    // Multiple edits
+    std::vector<jsonh_document::edit> edits = { jsonh_document::edit({ 0, 0, "# comment\n" }), jsonh_document::edit({ document.input().size() + 9, 0, " " }) };
+    REQUIRE(document.apply_edits(edits));
+    require_matches_full_parse();
+
+    // Invalid edit keeps previous element
+    json previous_element = document.element();
+    size_t colon_position = document.input().find("c:") + 1;
+    REQUIRE(!document.apply_edit(jsonh_document::edit({ colon_position, 1, "" })));
+    REQUIRE(!document.is_valid());
+    REQUIRE(document.element() == previous_element);
+    REQUIRE(document.apply_edit(jsonh_document::edit({ colon_position, 0, ":" })));
+    REQUIRE(document.is_valid());
+    require_matches_full_parse();
+
+    REQUIRE(document.apply_edit(jsonh_document::edit({ document.input().size() + 1, 0, "" })).error() == "Edit out of range of input");
+
+    // Multiple edits stop at first failure
+    std::string input_before_edits = document.input();
+    std::vector<jsonh_document::edit> failing_edits = { jsonh_document::edit({ input_before_edits.size() + 1, 0, "" }), jsonh_document::edit({ 0, 0, " " }) };
+    REQUIRE(document.apply_edits(failing_edits).error() == "Edit out of range of input");
+    REQUIRE(document.input() == input_before_edits);
+}
+TEST_CASE("QueryTest") {
+    std::string jsonh = R"(
+# Orders
+orders: [
+  { id: 1, customer: { name: Alice }, total: 25.5, items: [{ sku: a }, { sku: b }] }
+  { id: 2, customer: { name: Bob }, total: 10, items: [] }
+  { id: 3, customer: { name: Carol }, total: 40, items: [{ sku: c }] }
+]
+count: 3
+)";
+    auto select = [&](std::string_view text) -> std::vector<json> {
+        jsonh_query query = jsonh_query::compile(text).value();
+        std::vector<json> results;
+        jsonh_reader reader(jsonh);
+        for (nonstd::expected<json, std::string>&& result : reader.select(query)) {
+            results.push_back(std::move(result.value()));
+        }
+        // Same results as parsed element (objects in parsed element are sorted by property name)
+        std::vector<json> element_results = query.select(jsonh_reader::parse_element(jsonh).value());
+        std::vector<json> sorted_results = results;
+        std::sort(element_results.begin(), element_results.end());
+        std::sort(sorted_results.begin(), sorted_results.end());
+        REQUIRE(element_results == sorted_results);
+        return results;
+    };
+
+    REQUIRE(select(".count") == std::vector<json>({ 3 }));
+    REQUIRE(select(".orders[1].customer.name") == std::vector<json>({ "Bob" }));
+    REQUIRE(select(".orders[*].id") == std::vector<json>({ 1, 2, 3 }));
+    REQUIRE(select("..sku") == std::vector<json>({ "a", "b", "c" }));
+    REQUIRE(select(".orders[?(.total >= 25)].customer.name") == std::vector<json>({ "Alice", "Carol" }));
+    REQUIRE(select(".orders[?(.customer.name == \"Bob\")].id") == std::vector<json>({ 2 }));
+    REQUIRE(select(".orders[?(.customer.name)].id") == std::vector<json>({ 1, 2, 3 }));
+    REQUIRE(select(".orders[?(.missing)]") == std::vector<json>());
+    REQUIRE(select(".orders[*]{id, total}") == std::vector<json>({ json::parse(R"({"id": 1, "total": 25.5})"), json::parse(R"({"id": 2, "total": 10})"), json::parse(R"({"id": 3, "total": 40})") }));
+    REQUIRE(select(".").size() == 1);
+    REQUIRE(select("..*").size() == 26);
+    REQUIRE(select(".missing").empty());
+
+    // Braceless root object
+    jsonh_reader braceless_reader("a: 1\nb: { c: 2 }");
+    REQUIRE(to_vector(braceless_reader.select(jsonh_query::compile(".b.c").value())) == std::vector<nonstd::expected<json, std::string>>({ 2 }));
+
+    // Duplicate property policy (same results as parsed element)
+    std::string duplicate_jsonh = "{ a: 1, b: { c: 2 }, a: 3, b: { c: 4, d: 5 } }";
+    for (jsonh_duplicate_property_policy policy : { jsonh_duplicate_property_policy::last_wins, jsonh_duplicate_property_policy::first_wins, jsonh_duplicate_property_policy::collect }) {
+        jsonh_reader_options options;
+        options.duplicate_property_policy = policy;
+        for (std::string_view text : { ".a", "..*", ".b.c", ".*[?(.c >= 2)].d" }) {
+            jsonh_query query = jsonh_query::compile(text).value();
+            std::vector<json> results;
+            jsonh_reader duplicate_reader(duplicate_jsonh, options);
+            for (nonstd::expected<json, std::string>&& result : duplicate_reader.select(query)) {
+                results.push_back(std::move(result.value()));
+            }
+            std::vector<json> element_results = query.select(jsonh_reader::parse_element(duplicate_jsonh, options).value());
+            std::sort(results.begin(), results.end());
+            std::sort(element_results.begin(), element_results.end());
+            REQUIRE(results == element_results);
+            jsonh_reader duplicate_count_reader(duplicate_jsonh, options);
+            REQUIRE(duplicate_count_reader.count(query).value() == element_results.size());
+        }
+    }
+    jsonh_reader_options error_options;
+    error_options.duplicate_property_policy = jsonh_duplicate_property_policy::error;
+    jsonh_reader error_reader(duplicate_jsonh, error_options);
+    REQUIRE(!error_reader.count(jsonh_query::compile(".a").value()));
+
+    // Count
+    jsonh_reader count_reader(jsonh);
+    REQUIRE(count_reader.count(jsonh_query::compile("..name").value()).value() == 3);
+
+    // Errors
+    REQUIRE(jsonh_query::compile(".orders[").error() == "Expected item index in query");
+    REQUIRE(jsonh_query::compile(".orders[?(.a == {})]").error() == "Expected JSON literal in query predicate");
+    jsonh_reader invalid_reader("[1, 2");
+    REQUIRE(!invalid_reader.count(jsonh_query::compile("[*]").value()));
+}
+TEST_CASE("ExtractorTest") {
+    jsonh_extractor extractor = jsonh_extractor::compile({ "/id", "/user/name", "/tags/1", "/user", "/missing", "/a~1b" }).value();
+
+    std::vector<std::optional<json>> slots;
+    jsonh_reader reader(R"(
+{
+  // Event
+  id: 7
+  user: { name: Alice, age: 30 }
+  ignored: [1, 2, { id: 8 }]
+  tags: [x, y, z]
+  "a/b": true
+}
+)");
+    REQUIRE(reader.extract(extractor, slots).value() == 5);
+    REQUIRE(slots.size() == 6);
+    REQUIRE(slots[0] == json(7));
+    REQUIRE(slots[1] == json("Alice"));
+    REQUIRE(slots[2] == json("y"));
+    REQUIRE(slots[3] == json::parse(R"({"name": "Alice", "age": 30})"));
+    REQUIRE(!slots[4]);
+    REQUIRE(slots[5] == json(true));
+
+    // Same slots from parsed element
+    std::vector<std::optional<json>> element_slots;
+    REQUIRE(extractor.run(json::parse(R"({"id": 7, "user": {"name": "Alice", "age": 30}, "tags": ["x", "y", "z"], "a/b": true})"), element_slots) == 5);
+    REQUIRE(element_slots == slots);
+
+    // Many elements from one reader (rest of each element is skipped once every slot is filled)
+    jsonh_extractor a_extractor = jsonh_extractor::compile({ "/a" }).value();
+    jsonh_reader_options first_wins_options;
+    first_wins_options.duplicate_property_policy = jsonh_duplicate_property_policy::first_wins;
+    for (const jsonh_reader_options& options : { jsonh_reader_options(), first_wins_options }) {
+        jsonh_reader many_reader("{a: 1, b: {c: 2}}\n[[0], {a: 5}]\n{a: 3, b: 4}", options);
+        REQUIRE(many_reader.extract(a_extractor, slots).value() == 1);
+        REQUIRE(slots[0] == json(1));
+        REQUIRE(many_reader.extract(jsonh_extractor::compile({ "/0/0" }).value(), slots).value() == 1);
+        REQUIRE(slots[0] == json(0));
+        REQUIRE(many_reader.extract(a_extractor, slots).value() == 1);
+        REQUIRE(slots[0] == json(3));
+    }
+
+    // Braceless root object
+    jsonh_extractor id_extractor = jsonh_extractor::compile({ "/id" }).value();
+    jsonh_reader braceless_reader("name: x\nid: 2");
+    REQUIRE(braceless_reader.extract(id_extractor, slots).value() == 1);
+    REQUIRE(slots[0] == json(2));
+
+    // Duplicate property policy (same slots as parsed element)
+    jsonh_extractor duplicate_extractor = jsonh_extractor::compile({ "/a", "/b/c", "/b/d" }).value();
+    std::string duplicate_jsonh = "{ a: 1, b: { c: 2 }, a: 3, b: { d: 4 } }";
+    for (jsonh_duplicate_property_policy policy : { jsonh_duplicate_property_policy::last_wins, jsonh_duplicate_property_policy::first_wins, jsonh_duplicate_property_policy::collect }) {
+        jsonh_reader_options options;
+        options.duplicate_property_policy = policy;
+        jsonh_reader duplicate_reader(duplicate_jsonh, options);
+        REQUIRE(duplicate_reader.extract(duplicate_extractor, slots));
+        REQUIRE(duplicate_extractor.run(jsonh_reader::parse_element(duplicate_jsonh, options).value(), element_slots) == (size_t)std::count_if(slots.begin(), slots.end(), [](const std::optional<json>& slot) { return slot.has_value(); }));
+        REQUIRE(element_slots == slots);
+    }
+    jsonh_reader last_wins_reader(duplicate_jsonh);
+    REQUIRE(last_wins_reader.extract(duplicate_extractor, slots).value() == 2);
+    REQUIRE(slots == std::vector<std::optional<json>>({ json(3), std::nullopt, json(4) }));
+    jsonh_reader first_wins_reader(duplicate_jsonh, first_wins_options);
+    REQUIRE(first_wins_reader.extract(duplicate_extractor, slots).value() == 2);
+    REQUIRE(slots == std::vector<std::optional<json>>({ json(1), json(2), std::nullopt }));
+    jsonh_reader_options error_options;
+    error_options.duplicate_property_policy = jsonh_duplicate_property_policy::error;
+    jsonh_reader error_reader(duplicate_jsonh, error_options);
+    REQUIRE(error_reader.extract(duplicate_extractor, slots).error() == "Duplicate property name");
+
+    // Errors
+    REQUIRE(jsonh_extractor::compile({ "id" }).error() == "Expected `/` in extractor path");
+    REQUIRE(jsonh_extractor::compile({ "/a~2" }).error() == "Invalid escape in extractor path");
+    REQUIRE(jsonh_extractor::compile({ "/a", "/a" }).error() == "Duplicate extractor path: /a");
+    jsonh_reader invalid_reader("{ a: 1");
+    REQUIRE(!invalid_reader.extract(id_extractor, slots));
+}
+TEST_CASE("DiffTest") {
+    auto equals = [](std::string left, std::string right, jsonh_reader_options options = jsonh_reader_options()) -> bool {
+        jsonh_reader left_reader(left, options);
+        jsonh_reader right_reader(right, options);
+        bool is_equal = jsonh_reader::equals(left_reader, right_reader).value();
+        // Both elements are read to the end
+        REQUIRE(!left_reader.has_token());
+        REQUIRE(!right_reader.has_token());
+        return is_equal;
+    };
+    auto diff = [](std::string left, std::string right, jsonh_reader_options options = jsonh_reader_options()) -> json {
+        jsonh_reader left_reader(left, options);
+        jsonh_reader right_reader(right, options);
+        json patch = jsonh_reader::diff(left_reader, right_reader).value();
+        // Patch transforms left into right
+        REQUIRE(jsonh_reader::parse_element(left, options).value().patch(patch) == jsonh_reader::parse_element(right, options).value());
+        return patch;
+    };
+
+    // Quoting, number bases, comments and whitespace are ignored
+    REQUIRE(equals(R"({ "a": "x", b: [1, 0x10] })", R"(
+# Config
+a: x
+b: [
+  1 // one
+  16
+]
+)"));
+    REQUIRE(equals("{ a: 1, b: 2 }", "{ b: 2, a: 1 }"));
+    REQUIRE(!equals("{ a: 1, b: 2 }", "{ a: 1, b: 3 }"));
+    REQUIRE(!equals("[1, 2]", "[1, 2, 3]"));
+    REQUIRE(!equals("[1, 2]", "{ a: 1 }"));
+    REQUIRE(equals("'text'", "text"));
+
+    REQUIRE(diff("{ a: 1, b: 2 }", "{ a: 1, b: 2 }") == json::array());
+    REQUIRE(diff("{ a: 1, b: 2 }", "{ a: 1, b: 3 }") == json::parse(R"([{"op": "replace", "path": "/b", "value": 3}])"));
+    REQUIRE(diff("a: { b: [1, 2, 3] }", "a: { b: [1, 4] }") == json::parse(R"([{"op": "replace", "path": "/a/b/1", "value": 4}, {"op": "remove", "path": "/a/b/2"}])"));
+    REQUIRE(diff("[1]", "[1, [2], 3]") == json::parse(R"([{"op": "add", "path": "/1", "value": [2]}, {"op": "add", "path": "/2", "value": 3}])"));
+    REQUIRE(diff("{ x: 0, a: 1, b: 2 }", "{ x: 0, c: 3, b: 2 }") == json::parse(R"([{"op": "remove", "path": "/a"}, {"op": "add", "path": "/c", "value": 3}])"));
+    REQUIRE(diff("{ a: [1] }", "{ a: text }") == json::parse(R"([{"op": "replace", "path": "/a", "value": "text"}])"));
+    REQUIRE(diff("1", "2") == json::parse(R"([{"op": "replace", "path": "", "value": 2}])"));
+
+    // Duplicate property names
+    jsonh_reader_options last_wins_options = jsonh_reader_options();
+    REQUIRE(equals("{ a: 1, a: 2 }", "{ a: 2 }", last_wins_options));
+    REQUIRE(equals("{ a: 2, b: 3 }", "{ a: 1, b: 3, a: 2 }", last_wins_options));
+    REQUIRE(!equals("{ a: 1, a: 2 }", "{ a: 1 }", last_wins_options));
+    REQUIRE(equals("[{ a: 1, a: 2 }, 3]", "[{ a: 2 }, 3]", last_wins_options));
+    REQUIRE(diff("{ a: 1, a: 2 }", "{ a: 2 }", last_wins_options) == json::array());
+    REQUIRE(diff("{ x: 0, a: 1, a: 2 }", "{ x: 1, a: 3 }", last_wins_options) == json::parse(R"([{"op": "replace", "path": "/a", "value": 3}, {"op": "replace", "path": "/x", "value": 1}])"));
+
+    jsonh_reader_options first_wins_options = jsonh_reader_options();
+    first_wins_options.duplicate_property_policy = jsonh_duplicate_property_policy::first_wins;
+    REQUIRE(equals("{ a: 1, a: 2 }", "{ a: 1 }", first_wins_options));
+    REQUIRE(!equals("{ a: 1, a: 2 }", "{ a: 2 }", first_wins_options));
+    REQUIRE(diff("{ a: 1, a: 2 }", "{ a: 2 }", first_wins_options) == json::parse(R"([{"op": "replace", "path": "/a", "value": 2}])"));
+
+    jsonh_reader_options collect_options = jsonh_reader_options();
+    collect_options.duplicate_property_policy = jsonh_duplicate_property_policy::collect;
+    REQUIRE(equals("{ a: 1, a: 2 }", "{ a: [1, 2] }", collect_options));
+    REQUIRE(!equals("{ a: 1, a: 2 }", "{ a: 2 }", collect_options));
+    REQUIRE(diff("{ a: 1, b: 0, a: 2 }", "{ b: 0, a: [1, 3] }", collect_options) == json::parse(R"([{"op": "replace", "path": "/a/1", "value": 3}])"));
+
+    jsonh_reader_options error_options = jsonh_reader_options();
+    error_options.duplicate_property_policy = jsonh_duplicate_property_policy::error;
+    jsonh_reader duplicate_reader("{ a: 1, a: 2 }", error_options);
+    jsonh_reader unique_reader("{ a: 2 }", error_options);
+    REQUIRE(!jsonh_reader::equals(duplicate_reader, unique_reader));
+
+    // Errors
+    jsonh_reader invalid_reader("{ a: 1");
+    jsonh_reader valid_reader("{ a: 1 }");
+    REQUIRE(!jsonh_reader::diff(invalid_reader, valid_reader));
+}
+TEST_CASE("SemanticHashTest") {
+    auto semantic_hash = [](std::string jsonh, jsonh_reader_options options = jsonh_reader_options()) -> uint64_t {
+        uint64_t hash = jsonh_reader(jsonh, options).semantic_hash().value();
+        // Same hash as parsed element
+        REQUIRE(jsonh_semantic_hasher::hash(jsonh_reader::parse_element(jsonh, options).value()) == hash);
+        return hash;
+    };
+
+    // Comments, whitespace, quoting, number bases and property order are ignored
+    REQUIRE(semantic_hash(R"({ "a": "x", "b": [1, 16, { c: null }] })") == semantic_hash(R"(
+# Config
+b: [
+  1 // one
+  0x10
+  { 'c': null }
+]
+a: x
+)"));
+    REQUIRE(semantic_hash("[0.5, -0]") == semantic_hash("[5e-1, 0]"));
+
+    // Values, item order and types matter
+    REQUIRE(semantic_hash("{ a: 1 }") != semantic_hash("{ a: 2 }"));
+    REQUIRE(semantic_hash("{ a: 1 }") != semantic_hash("{ b: 1 }"));
+    REQUIRE(semantic_hash("[1, 2]") != semantic_hash("[2, 1]"));
+    REQUIRE(semantic_hash("[[1], [2]]") != semantic_hash("[[1, 2]]"));
+    REQUIRE(semantic_hash("'1'") != semantic_hash("1"));
+    REQUIRE(semantic_hash("{}") != semantic_hash("[]"));
+    REQUIRE(semantic_hash("{ a: { b: 1 }, c: 2 }") != semantic_hash("{ a: { c: 2 }, b: 1 }"));
+
+    // Duplicate property policy
+    REQUIRE(semantic_hash("{ a: 1, a: 2 }") == semantic_hash("{ a: 2 }"));
+    jsonh_reader_options first_wins_options;
+    first_wins_options.duplicate_property_policy = jsonh_duplicate_property_policy::first_wins;
+    REQUIRE(semantic_hash("{ a: 1, a: 2 }", first_wins_options) == semantic_hash("{ a: 1 }"));
+    jsonh_reader_options collect_options;
+    collect_options.duplicate_property_policy = jsonh_duplicate_property_policy::collect;
+    REQUIRE(semantic_hash("{ a: 1, b: 0, a: 2 }", collect_options) == semantic_hash("{ b: 0, a: [1, 2] }"));
+
+    // Bytes hashed in chunks
+    REQUIRE(jsonh_semantic_hasher::hash_bytes("abc") == jsonh_semantic_hasher::hash_bytes("c", jsonh_semantic_hasher::hash_bytes("ab")));
+    REQUIRE(jsonh_semantic_hasher::hash_bytes("") == jsonh_semantic_hasher::bytes_offset_basis);
+
+    // Errors
+    REQUIRE(!jsonh_reader("[1, 2").semantic_hash());
+}
+TEST_CASE("CanonicalJsonTest") {
+    auto canonical_json = [](std::string jsonh, jsonh_reader_options options = jsonh_reader_options()) -> std::string {
+        return jsonh_reader(jsonh, options).parse_canonical_json().value();
+    };
+
+    // Sorted properties, no whitespace or comments
+    REQUIRE(canonical_json(R"(
+# Config
+b: [true, null, { z: 1, y: 'text' }]
+a: { d: [], c: {} }
+)") == R"({"a":{"c":{},"d":[]},"b":[true,null,{"y":"text","z":1}]})");
+
+    // Numbers (RFC 8785 examples)
+    REQUIRE(canonical_json("[333333333.33333329, 1E30, 4.50, 2e-3, 0.000000000000000000000000001, -0, 0x10, 1e21, 123456789012345680000, -1.5e-7]")
+        == "[333333333.3333333,1e+30,4.5,0.002,1e-27,0,16,1e+21,123456789012345680000,-1.5e-7]");
+
+    // Property names sorted by UTF-16 code units (RFC 8785 example)
+    REQUIRE(canonical_json(R"({ "\u20ac": 1, "\r": 2, "\ufb33": 3, "1": 4, "\ud83d\ude00": 5, "\u0080": 6, "\u00f6": 7 })")
+        == "{\"\\r\":2,\"1\":4,\"\u0080\":6,\"\u00f6\":7,\"\u20ac\":1,\"\U0001F600\":5,\"\ufb33\":3}");
+
+    // Minimal escaping
+    REQUIRE(canonical_json(R"("a\"b\\c\n\u0001/\u2028")") == "\"a\\\"b\\\\c\\n\\u0001/\u2028\"");
+
+    // Duplicate property policy
+    REQUIRE(canonical_json("{ a: 1, b: 2, a: 3 }") == R"({"a":3,"b":2})");
+    jsonh_reader_options collect_options;
+    collect_options.duplicate_property_policy = jsonh_duplicate_property_policy::collect;
+    REQUIRE(canonical_json("{ a: 1, b: 2, a: { c: 3 } }", collect_options) == R"({"a":[1,{"c":3}],"b":2})");
+
+    // Stream output
+    std::ostringstream output;
+    REQUIRE(jsonh_reader("[{ b: 1, a: 2 }]").parse_canonical_json(output));
+    REQUIRE(output.str() == R"([{"a":2,"b":1}])");
+
+    // Single element
+    REQUIRE(canonical_json("[1] [2]") == "[1]");
+    REQUIRE(!jsonh_reader("[1] [2]", jsonh_reader_options({ .parse_single_element = true })).parse_canonical_json());
+    REQUIRE(canonical_json("[1] // comment", jsonh_reader_options({ .parse_single_element = true })) == "[1]");
+
+    // Errors
+    REQUIRE(!jsonh_reader("{ a: 1").parse_canonical_json());
+}